@@ -0,0 +1,160 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+// L8 (8-bit palette) framebuffer rendering. The UI only uses a couple of
+// colors, so pixels are palette indices and every primitive writes one byte
+// per pixel. Shared by the firmware and the host tools in tools/, so this
+// header must not depend on Mbed or the BSP.
+
+#include <stdint.h>
+#include <string.h>
+
+// The firmware defines RAM_FUNC before including this header to run the
+// glyph blitters from SRAM, since every frame goes through them; host
+// builds leave them where they are
+#ifndef RAM_FUNC
+#define RAM_FUNC
+#endif
+
+// -----------------------------
+// Palette
+// -----------------------------
+#define PALETTE_KEY  0            // Keyed out by the LTDC; shows the layer below
+#define PALETTE_TEXT 1
+#define PALETTE_SIZE 2
+
+// RGB888 value of each palette index, as loaded into the LTDC CLUT
+const uint32_t paletteRgb[PALETTE_SIZE] = {
+    0xFFFFFF, // PALETTE_KEY: white, matching the background layer
+    0x000000, // PALETTE_TEXT: black
+};
+
+// -----------------------------
+// Frame and Font
+// -----------------------------
+
+// One byte per pixel, rows packed back to back
+struct L8Frame {
+    uint8_t* pixels;
+    uint16_t width;
+    uint16_t height;
+};
+
+// Same table layout as the BSP sFONT fonts: glyphs for ' '..'~', each row
+// (width + 7) / 8 bytes, most significant bit leftmost.
+struct L8Font {
+    const uint8_t* table;
+    uint16_t width;
+    uint16_t height;
+};
+
+enum L8Align { L8_ALIGN_LEFT, L8_ALIGN_CENTER };
+
+// -----------------------------
+// Rendering Primitives
+// -----------------------------
+
+// Fill a rectangle, clipped to the frame
+RAM_FUNC inline void L8Fill(const L8Frame& frame, int x, int y, int w, int h, uint8_t index) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > frame.width) w = frame.width - x;
+    if (y + h > frame.height) h = frame.height - y;
+    if (w <= 0 || h <= 0) return;
+
+    if (x == 0 && w == frame.width) { // Whole rows are contiguous
+        memset(frame.pixels + y * frame.width, index, w * h);
+        return;
+    }
+    for (int row = 0; row < h; row++) {
+        memset(frame.pixels + (y + row) * frame.width + x, index, w);
+    }
+}
+
+// Draw one glyph cell; the cell background is painted with bg
+RAM_FUNC inline void L8DrawChar(const L8Frame& frame, const L8Font& font, int x, int y, char c, uint8_t fg, uint8_t bg) {
+    if (c < ' ' || c > '~') c = ' ';
+    if (x < 0 || y < 0 || x + font.width > frame.width || y + font.height > frame.height) return;
+
+    int rowBytes = (font.width + 7) / 8;
+    const uint8_t* glyph = font.table + (c - ' ') * font.height * rowBytes;
+
+    for (int row = 0; row < font.height; row++) {
+        uint8_t* dst = frame.pixels + (y + row) * frame.width + x;
+        const uint8_t* bits = glyph + row * rowBytes;
+        for (int col = 0; col < font.width; col++) {
+            dst[col] = (bits[col >> 3] & (0x80 >> (col & 7))) ? fg : bg;
+        }
+    }
+}
+
+// Place a string on one line: returns the left edge and trims length to
+// the characters that fit before the right edge, like the BSP does
+RAM_FUNC inline int L8Layout(const L8Frame& frame, const L8Font& font, int x, int& length, L8Align align) {
+    if (align == L8_ALIGN_CENTER) x = (frame.width - length * font.width) / 2;
+    if (x < 0) x = 0;
+
+    int room = (frame.width - x) / font.width;
+    if (length > room) length = room;
+    return x;
+}
+
+// Draw a string on one line
+RAM_FUNC inline void L8DrawString(const L8Frame& frame, const L8Font& font, int x, int y, const char* text,
+                                  L8Align align, uint8_t fg, uint8_t bg) {
+    int length = (int)strlen(text);
+    x = L8Layout(frame, font, x, length, align);
+
+    for (int i = 0; i < length; i++) {
+        L8DrawChar(frame, font, x + i * font.width, y, text[i], fg, bg);
+    }
+}
+
+// -----------------------------
+// Line Layout Cache
+// -----------------------------
+
+// The text last drawn on one line and where layout placed it. Fonts are
+// fixed width, so a string of the same length lands on the same cells and
+// only the characters that changed need repainting: a ticking clock touches
+// one or two digits per second instead of re-laying out the whole line.
+#define L8_LINE_MAX 32
+
+struct L8TextLine {
+    int16_t x;       // Left edge of the drawn text, -1 when the line is empty
+    uint8_t length;
+    char text[L8_LINE_MAX];
+};
+
+// Forget a line's contents, e.g. after the area under it was cleared
+inline void L8ResetLine(L8TextLine& line) {
+    line.x = -1;
+    line.length = 0;
+}
+
+// Bring a line up to date with text, drawing as few glyph cells as possible
+RAM_FUNC inline void L8UpdateLine(const L8Frame& frame, const L8Font& font, L8TextLine& line, int x, int y,
+                                  const char* text, L8Align align, uint8_t fg, uint8_t bg) {
+    int length = (int)strlen(text);
+    if (length > L8_LINE_MAX) length = L8_LINE_MAX;
+    x = L8Layout(frame, font, x, length, align);
+
+    if (x != line.x || length != line.length) { // Layout moved: clear and redraw
+        if (line.x >= 0) L8Fill(frame, line.x, y, line.length * font.width, font.height, bg);
+        for (int i = 0; i < length; i++) {
+            L8DrawChar(frame, font, x + i * font.width, y, text[i], fg, bg);
+        }
+        memcpy(line.text, text, length);
+        line.x = (int16_t)x;
+        line.length = (uint8_t)length;
+        return;
+    }
+
+    for (int i = 0; i < length; i++) { // Same cells: repaint only changed glyphs
+        if (line.text[i] == text[i]) continue;
+        L8DrawChar(frame, font, x + i * font.width, y, text[i], fg, bg);
+        line.text[i] = text[i];
+    }
+}
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+// Log record format and EEPROM layout. Shared by the firmware and the host
+// tools in tools/, so this header must not depend on Mbed.
+
+#include <stdint.h>
+
+// -----------------------------
+// EEPROM Geometry (24FC64F)
+// -----------------------------
+#define EEPROM_SIZE 8192          // Total capacity in bytes
+#define EEPROM_PAGE_SIZE 32       // Page write buffer; writes wrap within a page
+#define EEPROM_PAGES (EEPROM_SIZE / EEPROM_PAGE_SIZE)
+
+// Telemetry Layout (end of device): header page + one 32-bit write counter per page
+#define TELEMETRY_SIZE (EEPROM_PAGE_SIZE + EEPROM_PAGES * 4)
+#define TELEMETRY_BASE (EEPROM_SIZE - TELEMETRY_SIZE)
+#define TELEMETRY_COUNTERS (TELEMETRY_BASE + EEPROM_PAGE_SIZE)
+
+// Presence Index Layout (below telemetry): one DayPresence entry per day, indexed by day % INDEX_DAYS
+#define INDEX_DAYS 64
+#define INDEX_SIZE (INDEX_DAYS * 8)
+#define INDEX_BASE (TELEMETRY_BASE - INDEX_SIZE)
+
+// Alarm Table Layout (below the index): one AlarmEntry per alarm slot
+#define ALARM_SLOTS 128
+#define ALARM_SIZE (ALARM_SLOTS * 8)
+#define ALARM_BASE (INDEX_BASE - ALARM_SIZE)
+
+// Log Layout
+#define LOG_HEADER 0              // Header page holding the log generation
+#define LOG_BASE EEPROM_PAGE_SIZE // First byte of the record ring
+#define LOG_END ALARM_BASE        // One past the last byte of the ring
+#define LOG_RECORD_SIZE 8         // Bytes per record (4 records per page)
+#define LOG_CAPACITY ((LOG_END - LOG_BASE) / LOG_RECORD_SIZE)
+#define LOG_CHANNEL_USER 0        // Record source: onboard user button
+#define LOG_CHANNEL_ALARM 1       // Record source: scheduled alarm fired
+#define LOG_CHANNEL_LAP 2         // Record source: stopwatch lap
+
+// -----------------------------
+// Log Record Format
+// -----------------------------
+
+// One logged event, stored little-endian. Records are sized so a whole
+// number of them fill an EEPROM page, which makes every append a single
+// aligned page write.
+struct LogRecord {
+    uint32_t epoch;       // Seconds since 1970 (RTC time)
+    uint16_t subsecond;   // Fraction of a second in 1/65536 s (0 when unknown)
+    uint8_t tag;          // Bit 7: ring lap parity, bits 4-6: generation, bits 0-3: channel
+    uint8_t check;        // Low byte of the record CRC-32
+};
+
+static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "LogRecord layout must match LOG_RECORD_SIZE");
+static_assert(EEPROM_PAGE_SIZE % LOG_RECORD_SIZE == 0, "Records must not straddle EEPROM pages");
+static_assert(LOG_BASE % EEPROM_PAGE_SIZE == 0, "Log must start on a page boundary");
+static_assert(LOG_END % EEPROM_PAGE_SIZE == 0, "Log must end on a page boundary");
+
+#define TAG_LAP 0x80
+#define TAG_GENERATION_MASK 0x70
+#define TAG_GENERATION_SHIFT 4
+#define TAG_CHANNEL_MASK 0x0F
+
+// Record checksums use CRC-32/MPEG-2 (polynomial 0x04C11DB7, initial value
+// 0xFFFFFFFF, 32-bit words fed MSB first, no reflection), which is what the
+// STM32 CRC unit computes. The firmware defines LOG_HW_CRC and supplies
+// HwCrc32(); host builds use the bit-exact software version below.
+inline uint32_t SoftCrc32(const uint32_t* words, int count) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (int i = 0; i < count; i++) {
+        crc ^= words[i];
+        for (int bit = 0; bit < 32; bit++) {
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+#ifdef LOG_HW_CRC
+uint32_t HwCrc32(const uint32_t* words, int count);
+#endif
+
+// The record as CRC input words with the check byte cleared. The full log
+// generation is folded in so a stale record whose 3-bit generation tag
+// happens to alias the current one still fails its check.
+inline void RecordWords(const LogRecord& record, uint32_t generation, uint32_t* words) {
+    words[0] = record.epoch;
+    words[1] = record.subsecond | ((uint32_t)record.tag << 16);
+    words[2] = generation;
+}
+
+inline uint8_t RecordCrcSoft(const LogRecord& record, uint32_t generation) {
+    uint32_t words[3];
+    RecordWords(record, generation, words);
+    return (uint8_t)SoftCrc32(words, 3);
+}
+
+inline uint8_t RecordCrc(const LogRecord& record, uint32_t generation) {
+#ifdef LOG_HW_CRC
+    uint32_t words[3];
+    RecordWords(record, generation, words);
+    return (uint8_t)HwCrc32(words, 3);
+#else
+    return RecordCrcSoft(record, generation);
+#endif
+}
+
+// Records from earlier generations (before a clear) count as free space
+inline bool RecordIsValid(const LogRecord& record, uint32_t generation) {
+    if (record.epoch == 0xFFFFFFFF) return false; // Erased slot
+    if (((record.tag & TAG_GENERATION_MASK) >> TAG_GENERATION_SHIFT) != (generation & 7)) return false;
+    return record.check == RecordCrc(record, generation);
+}
+
+// -----------------------------
+// Log Header
+// -----------------------------
+
+// Clearing the log only bumps the generation. Two header slots share the
+// header page and are written alternately (by generation parity), so a torn
+// write leaves the previous generation readable in the other slot.
+struct LogHeader {
+    uint32_t magic;
+    uint32_t generation;
+    uint32_t check;               // SoftCrc32 over magic and generation
+    uint32_t reserved;
+};
+
+#define LOG_HEADER_MAGIC 0x4C4F4721 // "LOG!"
+#define LOG_HEADER_SLOT(generation) (LOG_HEADER + ((generation) & 1) * sizeof(LogHeader))
+
+static_assert(2 * sizeof(LogHeader) <= EEPROM_PAGE_SIZE, "Both header slots must share one page");
+static_assert(LOG_BASE >= LOG_HEADER + EEPROM_PAGE_SIZE, "Ring must not overlap the header page");
+
+inline LogHeader MakeLogHeader(uint32_t generation) {
+    LogHeader header = {LOG_HEADER_MAGIC, generation, 0, 0xFFFFFFFF};
+    header.check = SoftCrc32(&header.magic, 2);
+    return header;
+}
+
+// Current generation from the raw header page (0 for a never-cleared log)
+inline uint32_t LogGeneration(const LogHeader* slots) {
+    uint32_t generation = 0;
+    for (int i = 0; i < 2; i++) {
+        const LogHeader& h = slots[i];
+        bool valid = h.magic == LOG_HEADER_MAGIC && h.check == SoftCrc32(&h.magic, 2);
+        if (valid && h.generation >= generation) generation = h.generation;
+    }
+    return generation;
+}
+
+inline int LogSlotAddress(int slot) {
+    return LOG_BASE + slot * LOG_RECORD_SIZE;
+}
+
+// -----------------------------
+// Presence Index
+// -----------------------------
+
+// Which hours of a day saw at least one logged event. Entries are stamped
+// with the log generation so a clear invalidates them without rewriting.
+struct DayPresence {
+    uint32_t day;                 // Days since 1970
+    uint32_t hours;               // Bits 0-23: hour present, bits 24-31: generation
+};
+
+#define PRESENCE_HOURS_MASK 0x00FFFFFF
+#define PRESENCE_GENERATION_SHIFT 24
+
+static_assert(sizeof(DayPresence) * INDEX_DAYS == INDEX_SIZE, "DayPresence layout must match INDEX_SIZE");
+static_assert(INDEX_BASE % EEPROM_PAGE_SIZE == 0, "Index must start on a page boundary");
+
+inline int PresenceAddress(uint32_t day) {
+    return INDEX_BASE + (day % INDEX_DAYS) * sizeof(DayPresence);
+}
+
+// Hour mask for day, or 0 if the entry belongs to another day or generation
+inline uint32_t PresenceHours(const DayPresence& entry, uint32_t day, uint32_t generation) {
+    if (entry.day != day || (entry.hours >> PRESENCE_GENERATION_SHIFT) != (generation & 0xFF)) return 0;
+    return entry.hours & PRESENCE_HOURS_MASK;
+}
+
+// -----------------------------
+// Alarm Table
+// -----------------------------
+
+// A one-shot or recurring alarm. Recurring alarms keep their first deadline
+// and period, so firing never rewrites the entry: the next deadline after a
+// reset is derived from the current time.
+struct AlarmEntry {
+    uint32_t anchor;              // First deadline (seconds since 1970)
+    uint16_t period;              // Minutes between firings, 0 for one-shot
+    uint8_t flags;                // ALARM_ACTIVE for a slot in use
+    uint8_t check;                // Low byte of CRC-32 over the fields above
+};
+
+#define ALARM_ACTIVE 0x01
+
+static_assert(sizeof(AlarmEntry) * ALARM_SLOTS == ALARM_SIZE, "AlarmEntry layout must match ALARM_SIZE");
+static_assert(ALARM_BASE % EEPROM_PAGE_SIZE == 0, "Alarm table must start on a page boundary");
+
+inline int AlarmAddress(int slot) {
+    return ALARM_BASE + slot * sizeof(AlarmEntry);
+}
+
+inline uint8_t AlarmCrc(const AlarmEntry& alarm) {
+    uint32_t words[2] = {alarm.anchor, alarm.period | ((uint32_t)alarm.flags << 16)};
+#ifdef LOG_HW_CRC
+    return (uint8_t)HwCrc32(words, 2);
+#else
+    return (uint8_t)SoftCrc32(words, 2);
+#endif
+}
+
+// Erased (0xFF) and deleted (zeroed) slots both fail this
+inline bool AlarmIsValid(const AlarmEntry& alarm) {
+    return (alarm.flags & ALARM_ACTIVE) && alarm.check == AlarmCrc(alarm);
+}
+
+// First deadline at or after now; overdue one-shots are due immediately
+inline uint32_t AlarmNextDeadline(const AlarmEntry& alarm, uint32_t now) {
+    if (alarm.anchor >= now || alarm.period == 0) return alarm.anchor;
+    uint32_t period = alarm.period * 60UL;
+    return alarm.anchor + (now - alarm.anchor + period - 1) / period * period;
+}
+
+// -----------------------------
+// Ring Head Recovery
+// -----------------------------
+
+// Locates the ring head from records fed in slot order. The ring is written
+// in order and each wrap flips the lap bit, so the head is the first slot
+// that is blank or carries a different lap than slot 0.
+class LogScan {
+public:
+    int head;                     // Slot the next record goes to
+    int count;                    // Number of valid records in the ring
+    uint8_t lap;                  // Lap parity for the next record
+
+    explicit LogScan(uint32_t generation)
+        : head(0), count(0), lap(0), generation(generation), slot(0), firstLap(0) {}
+
+    // Feed the record at the next slot; returns false once the head is known
+    bool Feed(const LogRecord& record) {
+        if (slot < 0) return false;
+
+        bool valid = RecordIsValid(record, generation);
+        uint8_t recordLap = record.tag & TAG_LAP;
+
+        if (slot == 0) {
+            if (!valid) return Done(); // Empty log
+            firstLap = recordLap;
+        } else if (!valid || recordLap != firstLap) {
+            head = slot;
+            count = valid ? LOG_CAPACITY : slot; // Older lap beyond head → ring is full
+            lap = firstLap;
+            return Done();
+        }
+
+        if (++slot == LOG_CAPACITY) {
+            // Every slot carries the same lap: ring is full and wraps back to slot 0
+            head = 0;
+            count = LOG_CAPACITY;
+            lap = firstLap ^ TAG_LAP;
+            return Done();
+        }
+        return true;
+    }
+
+    // Slot of the oldest valid record
+    int OldestSlot() const {
+        return (head - count + LOG_CAPACITY) % LOG_CAPACITY;
+    }
+
+private:
+    uint32_t generation;          // Only records of this generation count
+    int slot;                     // Next slot expected, -1 when finished
+    uint8_t firstLap;
+
+    bool Done() {
+        slot = -1;
+        return false;
+    }
+};
+
+#endif
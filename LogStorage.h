@@ -0,0 +1,256 @@
+#ifndef LOG_STORAGE_H
+#define LOG_STORAGE_H
+
+// Storage engine on top of the EEPROM layout in LogFormat.h: the log ring,
+// the presence index and the endurance telemetry checkpoints. Shared by the
+// firmware and the simulators in tools/, so this header must not depend on
+// Mbed. The device comes in as a Backend with
+//     void Write(unsigned eeaddress, const void* data, int size); // One page write, counted in Telemetry
+//     void Read(unsigned eeaddress, void* data, int size);        // Sequential read
+//     void ReadCached(unsigned eeaddress, void* data, int size);  // Read within one page, may be served from RAM
+//     uint32_t UptimeSeconds();
+// which is the I2C driver on target and an EEPROM model on the host.
+
+#include "LogFormat.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TELEMETRY_INTERVAL 64     // Log appends between checkpoints
+#define EEPROM_ENDURANCE 1000000UL // Rated write cycles per page
+#define TELEMETRY_MAGIC 0x57454152 // "WEAR"
+
+// -----------------------------
+// Endurance Telemetry Counters
+// -----------------------------
+
+// Every write transaction reprograms one whole EEPROM page regardless of how
+// many bytes it carries, so wear is tracked per page in physical bytes and
+// compared against the logical payload the application asked to store.
+struct Telemetry {
+    uint32_t pageWrites[EEPROM_PAGES]; // Write cycles per page
+    uint64_t logicalBytes;        // Payload bytes stored by the log
+    uint64_t busBytes;            // Data bytes sent in write transactions
+    uint64_t physicalBytes;       // Page bytes reprogrammed
+    uint32_t baseSeconds;         // Operating time restored from the last checkpoint
+    uint32_t dirtyCounterPages;   // Counter pages changed since the last checkpoint
+    int sinceCheckpoint;          // Log appends since the last checkpoint
+
+    // Called by the backend for every write transaction, whoever issues it
+    void CountWrite(unsigned eeaddress, int size) {
+        int page = (eeaddress % EEPROM_SIZE) / EEPROM_PAGE_SIZE;
+
+        pageWrites[page]++;
+        busBytes += size;
+        physicalBytes += EEPROM_PAGE_SIZE;
+        dirtyCounterPages |= 1UL << (page * 4 / EEPROM_PAGE_SIZE);
+    }
+};
+
+// Aggregates persisted in the telemetry header page
+struct TelemetryHeader {
+    uint32_t magic;
+    uint32_t operatingSeconds;
+    uint64_t logicalBytes;
+    uint64_t busBytes;
+    uint64_t physicalBytes;
+};
+static_assert(sizeof(TelemetryHeader) <= EEPROM_PAGE_SIZE, "Telemetry header must fit in one page");
+static_assert(EEPROM_PAGES * 4 / EEPROM_PAGE_SIZE <= 32, "Counter pages must fit the dirty mask");
+
+// Wear lines of the diagnostics screen; seconds is the total operating time.
+// Returns false past the last line so callers can append their own.
+inline bool WearLine(const Telemetry& telemetry, uint64_t seconds, int line, char* out) {
+    int hotPage = 0;
+    for (int i = 1; i < EEPROM_PAGES; i++) {
+        if (telemetry.pageWrites[i] > telemetry.pageWrites[hotPage]) hotPage = i;
+    }
+    uint32_t maxCycles = telemetry.pageWrites[hotPage];
+
+    switch (line) {
+        // Each write transaction reprograms exactly one page, so the checkpointed
+        // physical byte total doubles as the lifetime write count
+        case 0: sprintf(out, "Writes %lu", (unsigned long)(telemetry.physicalBytes / EEPROM_PAGE_SIZE)); return true;
+        case 1: sprintf(out, "Data %lu B", (unsigned long)telemetry.logicalBytes); return true;
+        case 2: sprintf(out, "Bus %lu B", (unsigned long)telemetry.busBytes); return true;
+        case 3: sprintf(out, "Wear %lu B", (unsigned long)telemetry.physicalBytes); return true;
+        case 4: {
+            // Write amplification = physical / logical, shown with two decimals
+            uint32_t waf100 = telemetry.logicalBytes ? (uint32_t)(telemetry.physicalBytes * 100 / telemetry.logicalBytes) : 0;
+            sprintf(out, "WAF %lu.%02lu", (unsigned long)(waf100 / 100), (unsigned long)(waf100 % 100));
+            return true;
+        }
+        case 5: sprintf(out, "Hot pg %d x%lu", hotPage, (unsigned long)maxCycles); return true;
+        case 6: {
+            // Project remaining life of the hottest page at the observed rate
+            if (maxCycles == 0 || seconds == 0) {
+                sprintf(out, "Life n/a");
+            } else {
+                uint64_t left = maxCycles >= EEPROM_ENDURANCE ? 0 : EEPROM_ENDURANCE - maxCycles;
+                uint64_t days = left * seconds / ((uint64_t)maxCycles * 86400);
+                sprintf(out, "Life %lu days", (unsigned long)days);
+            }
+            return true;
+        }
+        default: return false;
+    }
+}
+
+// -----------------------------
+// Storage Engine
+// -----------------------------
+
+// RAM state kept for the log, index and telemetry. Lost on a power cycle and
+// rebuilt from the EEPROM by LogInit(), IndexLoad() and TelemetryLoad().
+template <typename Backend>
+class LogStorage {
+public:
+    int logHead;                  // Slot the next record is written to
+    int logCount;                 // Number of valid records in the ring
+    uint8_t logLap;               // Lap parity stamped into new records
+    uint32_t logGeneration;       // Bumped by every clear
+
+    LogStorage(Backend& eeprom, Telemetry& telemetry)
+        : logHead(0), logCount(0), logLap(0), logGeneration(0), eeprom(eeprom), telemetry(telemetry) {}
+
+    // Recover head position after reset by scanning the ring in large blocks
+    void LogInit() {
+        const int BLOCK_RECORDS = 32;
+        LogRecord block[BLOCK_RECORDS];
+        LogHeader header[2];
+        eeprom.Read(LOG_HEADER, header, sizeof(header));
+        logGeneration = LogGeneration(header);
+
+        LogScan scan(logGeneration);
+        bool scanning = true;
+
+        for (int slot = 0; scanning && slot < LOG_CAPACITY; slot += BLOCK_RECORDS) {
+            int count = LOG_CAPACITY - slot;
+            if (count > BLOCK_RECORDS) count = BLOCK_RECORDS;
+            eeprom.Read(LogSlotAddress(slot), block, count * LOG_RECORD_SIZE);
+
+            for (int i = 0; scanning && i < count; i++) {
+                scanning = scan.Feed(block[i]);
+            }
+        }
+
+        logHead = scan.head;
+        logCount = scan.count;
+        logLap = scan.lap;
+    }
+
+    // Append one record in a single page-aligned write
+    void LogAppend(LogRecord record) {
+        record.tag = (record.tag & TAG_CHANNEL_MASK) | logLap |
+                     ((logGeneration & 7) << TAG_GENERATION_SHIFT);
+        record.check = RecordCrc(record, logGeneration);
+
+        eeprom.Write(LogSlotAddress(logHead), &record, sizeof(record));
+
+        if (++logHead == LOG_CAPACITY) {
+            logHead = 0;
+            logLap ^= TAG_LAP;
+        }
+        if (logCount < LOG_CAPACITY) logCount++;
+
+        IndexAdd(record.epoch);
+
+        telemetry.logicalBytes += sizeof(record);
+        if (++telemetry.sinceCheckpoint >= TELEMETRY_INTERVAL) TelemetryCheckpoint();
+    }
+
+    // Read the record written age appends ago (0 = newest)
+    bool LogReadNewest(int age, LogRecord* record) {
+        if (age >= logCount) return false;
+
+        int slot = (logHead - 1 - age + LOG_CAPACITY) % LOG_CAPACITY;
+        eeprom.ReadCached(LogSlotAddress(slot), record, sizeof(*record));
+        return RecordIsValid(*record, logGeneration);
+    }
+
+    // Clear the log with one header write instead of erasing the device: records
+    // of the old generation become free space and are overwritten from slot 0
+    void LogClear() {
+        LogHeader header = MakeLogHeader(logGeneration + 1);
+        eeprom.Write(LOG_HEADER_SLOT(header.generation), &header, sizeof(header));
+
+        logGeneration = header.generation;
+        logHead = 0;
+        logCount = 0;
+        logLap = 0;
+    }
+
+    // RAM copy of the per-day hour-presence index. An append touches the
+    // EEPROM only for the first event of an hour (4 bytes) or of a day
+    // (8 bytes), and overview queries never read the log itself. The index
+    // keeps its history after the ring overwrites the records behind it.
+    void IndexLoad() {
+        eeprom.Read(INDEX_BASE, presence, sizeof(presence));
+    }
+
+    // Hour mask for the given day (0 if nothing was logged or it aged out)
+    uint32_t IndexHours(uint32_t day) const {
+        return PresenceHours(presence[day % INDEX_DAYS], day, logGeneration);
+    }
+
+    // Restore counters from the last checkpoint (fresh chips start at zero)
+    void TelemetryLoad() {
+        TelemetryHeader header;
+        eeprom.Read(TELEMETRY_BASE, &header, sizeof(header));
+        if (header.magic != TELEMETRY_MAGIC) return;
+
+        eeprom.Read(TELEMETRY_COUNTERS, telemetry.pageWrites, sizeof(telemetry.pageWrites));
+        telemetry.baseSeconds = header.operatingSeconds;
+        telemetry.logicalBytes = header.logicalBytes;
+        telemetry.busBytes = header.busBytes;
+        telemetry.physicalBytes = header.physicalBytes;
+    }
+
+    // Write back changed counter pages and the aggregate header
+    void TelemetryCheckpoint() {
+        uint32_t dirty = telemetry.dirtyCounterPages;
+        telemetry.dirtyCounterPages = 0; // Checkpoint writes below re-mark their own pages
+        telemetry.sinceCheckpoint = 0;
+
+        for (int i = 0; dirty != 0; i++, dirty >>= 1) {
+            if (dirty & 1) {
+                eeprom.Write(TELEMETRY_COUNTERS + i * EEPROM_PAGE_SIZE,
+                             &telemetry.pageWrites[i * EEPROM_PAGE_SIZE / 4], EEPROM_PAGE_SIZE);
+            }
+        }
+
+        TelemetryHeader header;
+        header.magic = TELEMETRY_MAGIC;
+        header.operatingSeconds = telemetry.baseSeconds + eeprom.UptimeSeconds();
+        header.logicalBytes = telemetry.logicalBytes;
+        header.busBytes = telemetry.busBytes;
+        header.physicalBytes = telemetry.physicalBytes;
+        eeprom.Write(TELEMETRY_BASE, &header, sizeof(header));
+    }
+
+private:
+    Backend& eeprom;
+    Telemetry& telemetry;
+    DayPresence presence[INDEX_DAYS];
+
+    void IndexAdd(uint32_t epoch) {
+        uint32_t day = epoch / 86400;
+        uint32_t hourBit = 1UL << ((epoch % 86400) / 3600);
+        DayPresence& entry = presence[day % INDEX_DAYS];
+        uint32_t hours = PresenceHours(entry, day, logGeneration);
+
+        if (hours & hourBit) return; // Already marked: no write
+
+        uint32_t stamped = hours | hourBit | ((logGeneration & 0xFF) << PRESENCE_GENERATION_SHIFT);
+        if (hours != 0) {
+            entry.hours = stamped;
+            eeprom.Write(PresenceAddress(day) + 4, &entry.hours, 4);
+        } else {
+            entry.day = day;
+            entry.hours = stamped;
+            eeprom.Write(PresenceAddress(day), &entry, sizeof(entry));
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef LOG_STREAM_H
+#define LOG_STREAM_H
+
+// CSV export of the log ring, as sent over USB by command 'd'. Shared by the
+// firmware and the host tools in tools/, so this header must not depend on
+// Mbed: records come from a Source with
+//     void Read(unsigned eeaddress, char* data, int size);
+// which is the EEPROM on target and a mapped image on the host.
+
+#include "LogFormat.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Generates the log as CSV text on the fly, oldest record first. EEPROM
+// contents are pulled in large sequential blocks ahead of the formatter so
+// the sink is fed from RAM instead of one bus transaction per record. Times
+// are printed as UTC, which is what the board's RTC keeps.
+template <typename Source>
+class LogStream {
+public:
+    static const int BLOCK_RECORDS = 8; // Read-ahead block (two EEPROM pages)
+
+    LogStream(Source& source, int head, int count, uint32_t generation)
+        : source(source), generation(generation), slot((head - count + LOG_CAPACITY) % LOG_CAPACITY),
+          remaining(count), index(-1), blockLen(0), blockPos(0), lineLen(0), linePos(0) {}
+
+    // Fill out with up to capacity bytes of CSV; returns 0 once the log is exhausted
+    int Read(char* out, int capacity) {
+        int written = 0;
+        while (written < capacity) {
+            if (linePos == lineLen && !NextLine()) break;
+            int n = lineLen - linePos;
+            if (n > capacity - written) n = capacity - written;
+            memcpy(&out[written], &line[linePos], n);
+            linePos += n;
+            written += n;
+        }
+        return written;
+    }
+
+private:
+    Source& source;
+    uint32_t generation;          // Only records of this generation are exported
+    int slot;                     // Next ring slot to prefetch
+    int remaining;                // Records not yet prefetched
+    int index;                    // Output row number (-1 = header)
+    LogRecord block[BLOCK_RECORDS]; // Read-ahead buffer
+    int blockLen, blockPos;
+    char line[64];
+    int lineLen, linePos;
+
+    // Take the next record from the read-ahead buffer, refilling it as needed.
+    // Refills stop at the end of the ring so each one is a single sequential read.
+    bool NextRecord(LogRecord* record) {
+        if (blockPos == blockLen) {
+            if (remaining == 0) return false;
+            blockLen = LOG_CAPACITY - slot;
+            if (blockLen > BLOCK_RECORDS) blockLen = BLOCK_RECORDS;
+            if (blockLen > remaining) blockLen = remaining;
+
+            source.Read(LogSlotAddress(slot), (char*)block, blockLen * LOG_RECORD_SIZE);
+            slot = (slot + blockLen) % LOG_CAPACITY;
+            remaining -= blockLen;
+            blockPos = 0;
+        }
+        *record = block[blockPos++];
+        return true;
+    }
+
+    bool NextLine() {
+        if (index < 0) {
+            lineLen = sprintf(line, "index,epoch,subsecond,channel,time\n");
+            linePos = 0;
+            index++;
+            return true;
+        }
+
+        LogRecord record;
+        do {
+            if (!NextRecord(&record)) return false;
+        } while (!RecordIsValid(record, generation)); // Skip damaged slots
+
+        uint32_t second = record.epoch % 86400;
+        lineLen = sprintf(line, "%d,%lu,%u,%u,%02u:%02u:%02u\n", index, (unsigned long)record.epoch,
+                          record.subsecond, record.tag & TAG_CHANNEL_MASK, (unsigned)(second / 3600),
+                          (unsigned)(second / 60 % 60), (unsigned)(second % 60));
+        linePos = 0;
+        index++;
+        return true;
+    }
+};
+
+#endif
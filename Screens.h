@@ -0,0 +1,180 @@
+#ifndef SCREENS_H
+#define SCREENS_H
+
+// The clock's screens and the text formatting behind them. Shared by the
+// firmware and the host tools in tools/, so this header must not depend on
+// Mbed or the BSP. Screens draw through an Lcd with
+//     bool EnterScreen(int screen, uint16_t y, uint16_t height); // True when the labels must be drawn
+//     void Label(uint16_t y, const char* text, L8Align align);     // Static layer, redrawn per screen
+//     void DynamicText(uint16_t y, const char* text, L8Align align); // Line in the dynamic window
+//     uint16_t Height();
+// which is the LTDC compositor on target and SimLcd on the host. Times are
+// shown as UTC, which is what the board's RTC keeps.
+
+#include "Framebuffer.h"
+#include "LogFormat.h"
+
+#include <stdio.h>
+#include <time.h>
+
+// The firmware defines RAM_FUNC before including this header to run the
+// per-frame formatters from SRAM; host builds leave them where they are
+#ifndef RAM_FUNC
+#define RAM_FUNC
+#endif
+
+#define HISTORY_ROWS 8            // Records shown per history screen
+
+// Identifies the screen whose labels are on the static layer
+enum ScreenId {
+    SCREEN_TIME,
+    SCREEN_SET_TIME,
+    SCREEN_HISTORY,
+    SCREEN_DIAGNOSTICS,
+    SCREEN_STOPWATCH,
+};
+
+// -----------------------------
+// Text Formatting
+// -----------------------------
+
+// Format HH:MM:SS without going through printf
+RAM_FUNC inline void FormatHms(char* out, int hours, int minutes, int seconds) {
+    out[0] = '0' + hours / 10;
+    out[1] = '0' + hours % 10;
+    out[2] = ':';
+    out[3] = '0' + minutes / 10;
+    out[4] = '0' + minutes % 10;
+    out[5] = ':';
+    out[6] = '0' + seconds / 10;
+    out[7] = '0' + seconds % 10;
+    out[8] = '\0';
+}
+
+// Format a record as HH:MM:SS
+inline void FormatRecordTime(const LogRecord& record, char* out) {
+    time_t when = record.epoch;
+    struct tm* timeinfo = gmtime(&when);
+    FormatHms(out, timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
+}
+
+// Elapsed time as HH:MM:SS.hh, rewritten in place: the HH:MM:SS part is
+// only reformatted when the whole second changes.
+struct ElapsedText {
+    char text[12];
+    uint32_t seconds;             // Second currently formatted, ~0 forces a rewrite
+};
+
+RAM_FUNC inline void FormatElapsed(ElapsedText& out, uint64_t us) {
+    uint32_t seconds = (uint32_t)(us / 1000000);
+    if (seconds != out.seconds) {
+        FormatHms(out.text, (seconds / 3600) % 100, (seconds / 60) % 60, seconds % 60);
+        out.text[8] = '.';
+        out.text[11] = '\0';
+        out.seconds = seconds;
+    }
+    uint32_t hundredths = (uint32_t)(us % 1000000) / 10000;
+    out.text[9] = '0' + hundredths / 10;
+    out.text[10] = '0' + hundredths % 10;
+}
+
+// -----------------------------
+// Screens
+// -----------------------------
+
+// Show live current RTC time
+template <typename Lcd>
+void ShowTime(Lcd& lcd, time_t now) {
+    if (lcd.EnterScreen(SCREEN_TIME, 100, 20)) {
+        lcd.Label(60, "Current Time", L8_ALIGN_CENTER);
+        lcd.Label(140, "(HH:MM:SS)", L8_ALIGN_CENTER);
+    }
+
+    struct tm* timeinfo = gmtime(&now);
+    char timebuff[20];
+    FormatHms(timebuff, timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
+
+    lcd.DynamicText(100, timebuff, L8_ALIGN_CENTER);
+}
+
+// Display editable RTC time (with field highlighting)
+template <typename Lcd>
+void SetTime(Lcd& lcd, time_t selected, int field) {
+    struct tm* timeInfo = gmtime(&selected);
+    char timebuff[20];
+
+    if (field == 0)      sprintf(timebuff, "|%02d|:%02d:%02d", timeInfo->tm_hour, timeInfo->tm_min, timeInfo->tm_sec);
+    else if (field == 1) sprintf(timebuff, "%02d:|%02d|:%02d", timeInfo->tm_hour, timeInfo->tm_min, timeInfo->tm_sec);
+    else                 sprintf(timebuff, "%02d:%02d:|%02d|", timeInfo->tm_hour, timeInfo->tm_min, timeInfo->tm_sec);
+
+    if (lcd.EnterScreen(SCREEN_SET_TIME, 100, 20)) {
+        lcd.Label(60, "Set Time", L8_ALIGN_CENTER);
+        lcd.Label(140, "(HH:MM:SS)", L8_ALIGN_CENTER);
+    }
+
+    lcd.DynamicText(100, timebuff, L8_ALIGN_CENTER);
+}
+
+// Show a window of logged button press times, newest first. Storage provides
+//     bool LogReadNewest(int age, LogRecord* record);
+template <typename Lcd, typename Storage>
+void ShowPreviousTimes(Lcd& lcd, Storage& storage, int offset) {
+    if (lcd.EnterScreen(SCREEN_HISTORY, 120, HISTORY_ROWS * 20)) {
+        lcd.Label(60, "Previous Times:", L8_ALIGN_LEFT);
+        lcd.Label(80, "(HH:MM:SS)", L8_ALIGN_LEFT);
+    }
+
+    for (int row = 0; row < HISTORY_ROWS; row++) {
+        char timebuff[20] = "--:--:--";
+        char linebuff[32];
+        LogRecord record;
+
+        if (storage.LogReadNewest(offset + row, &record)) FormatRecordTime(record, timebuff);
+        sprintf(linebuff, "%4d %s", offset + row + 1, timebuff);
+        lcd.DynamicText(120 + row * 20, linebuff, L8_ALIGN_LEFT);
+    }
+}
+
+// Show diagnostic lines until the source runs out; lines(n, out) fills out
+// with line n and returns false past the last one
+template <typename Lcd, typename Lines>
+void ShowDiagnostics(Lcd& lcd, Lines lines) {
+    char linebuff[32];
+
+    if (lcd.EnterScreen(SCREEN_DIAGNOSTICS, 50, lcd.Height() - 50)) {
+        lcd.Label(20, "Diagnostics", L8_ALIGN_CENTER);
+    }
+
+    for (int line = 0; lines(line, linebuff); line++) {
+        lcd.DynamicText(50 + line * 20, linebuff, L8_ALIGN_LEFT);
+    }
+}
+
+// Show the running stopwatch and the newest lap split. lapCount is the lap
+// number the FSM has reached, lapsRecorded the newest lap the main loop has
+// logged and newestSplitUs that lap's split; a lap still waiting in the
+// queue shows as "L--" rather than with the previous lap's split.
+template <typename Lcd>
+void ShowStopwatch(Lcd& lcd, uint64_t elapsedUs, int lapCount, int lapsRecorded, uint64_t newestSplitUs) {
+    static ElapsedText elapsed = {"", 0xFFFFFFFF};
+    static ElapsedText split = {"", 0xFFFFFFFF};
+    char linebuff[32];
+
+    if (lcd.EnterScreen(SCREEN_STOPWATCH, 100, 60)) {
+        lcd.Label(60, "Stopwatch", L8_ALIGN_CENTER);
+        lcd.Label(180, "(HH:MM:SS.hh)", L8_ALIGN_CENTER);
+    }
+
+    FormatElapsed(elapsed, elapsedUs);
+    lcd.DynamicText(100, elapsed.text, L8_ALIGN_CENTER);
+
+    if (lapCount > 0 && lapsRecorded == lapCount) {
+        FormatElapsed(split, newestSplitUs);
+        sprintf(linebuff, "L%-3d %s", lapsRecorded, split.text);
+    } else {
+        sprintf(linebuff, "L--");
+    }
+    lcd.DynamicText(140, linebuff, L8_ALIGN_CENTER);
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+// Sequence lock for state shared between ISRs and the main loop. The sequence
+// is odd while a write is in progress; readers copy the value and retry if
+// the sequence was odd or changed meanwhile, so they never see a torn update
+// and writers never wait. Shared by the firmware and the host tools in
+// tools/: on target the barriers are DMBs, on the host they are full fences.
+
+#include <stdint.h>
+#include <atomic>
+
+#if defined(__CORTEX_M)
+#define SEQLOCK_BARRIER() __DMB()
+#else
+#define SEQLOCK_BARRIER() std::atomic_thread_fence(std::memory_order_seq_cst)
+#endif
+
+template <typename T>
+class SeqLock {
+public:
+    explicit SeqLock(const T& initial) : sequence(0), retries(0), value(initial) {}
+
+    // Apply update to the value. Writers must not preempt each other: call
+    // from ISR context, or from thread context inside a critical section.
+    template <typename F>
+    void Write(F update) {
+        sequence = sequence + 1;
+        SEQLOCK_BARRIER();
+        update(value);
+        SEQLOCK_BARRIER();
+        sequence = sequence + 1;
+    }
+
+    // Return a consistent copy of the value
+    T Read() {
+        for (;;) {
+            uint32_t start = sequence;
+            SEQLOCK_BARRIER();
+            T copy = value;
+            SEQLOCK_BARRIER();
+            if (!(start & 1) && sequence == start) return copy;
+            retries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t Retries() const { return retries.load(std::memory_order_relaxed); }
+
+private:
+    volatile uint32_t sequence;
+    std::atomic<uint32_t> retries; // Reads repeated because a writer intervened
+    T value;
+};
+
+#endif
@@ -1,6 +1,12 @@
 #include "LCD_DISCO_F429ZI.h"
 #include "DebouncedInterrupt.h"
+#include "USBSerial.h"
 #include "mbed.h"
+#define LOG_HW_CRC                // Record checksums use the CRC peripheral
+#include "LogFormat.h"
+#include "LogStorage.h"
+#include "LogStream.h"
+#include "SeqLock.h"
 #include <cstdint>
 #include <time.h>
 
@@ -10,16 +16,32 @@
 #define SDA_PIN PC_9
 #define SCL_PIN PA_8
 #define EEPROM_ADDR 0xA0          // 7-bit device address shifted left by 1 (0x50 << 1)
+#define I2C_FREQUENCY 100000      // Bus clock (Hz), reapplied after each CPU clock change
 
-// EEPROM Memory Addresses
-#define EEPROM_ADDR_1 0           // Address for most recent time
-#define EEPROM_ADDR_2 20          // Address for previous time
+// Geometry, log and telemetry layout live in LogFormat.h, the checkpoint
+// interval and rated endurance in LogStorage.h
+
+// Stopwatch
+#define LAP_QUEUE 16              // Laps captured ahead of their EEPROM writes
+#define LAP_HISTORY 32            // Recent laps kept in RAM for split export
+
+// History Browsing
+#define CACHE_PAGES 8             // EEPROM pages held in RAM
+#define PREFETCH_DEPTH 2          // Pages fetched ahead of the history window
+
+// Frequency Governor
+#define GOVERNOR_HOLD_FRAMES 20   // Idle frames (~2 s) before dropping to the low clock
+
+// Alarm Scheduler
+#define WHEEL_LEVELS 4            // Timer wheel levels (covers 64^4 s ≈ 194 days directly)
+#define WHEEL_BITS 6              // log2 of slots per level
 
 // -----------------------------
 // Hardware Peripherals
 // -----------------------------
 LCD_DISCO_F429ZI LCD;             // LCD display object
 I2C i2c(SDA_PIN, SCL_PIN);        // I2C interface
+USBSerial usbSerial(false);       // USB CDC port for log download (non-blocking connect)
 
 // Input buttons (interrupt-driven)
 InterruptIn userButton(BUTTON1);  // Onboard user button
@@ -27,220 +49,1479 @@ DebouncedInterrupt displayButton(PA_6);   // External button: Toggle time/log di
 DebouncedInterrupt cycleButton(PC_2);     // External button: Select field (hours/mins/sec)
 DebouncedInterrupt incrementButton(PC_3); // External button: Increment selected field
 
-// -----------------------------
-// Global Variables
-// -----------------------------
-int selectedField = 0;            // Tracks which time field is selected (0 = hours, 1 = mins, 2 = secs)
-char prevTime1[20], prevTime2[20]; // Buffers for EEPROM-stored times
-bool timeIsDirty = false;         // Flag to indicate RTC update required
-time_t rawTime;                   // Current system time
-time_t selectedTime;              // Used when adjusting RTC time
-
 // -----------------------------
 // Finite State Machine States
 // -----------------------------
 enum SystemState {
     DISPLAY_TIME,   // Default: show current time on LCD
     SAVE_TIME,      // Save timestamp to EEPROM
-    PREV_TIMES,     // Show last two saved times
-    SET_TIME        // User adjusting RTC via buttons
+    PREV_TIMES,     // Browse saved times
+    DIAGNOSTICS,    // EEPROM wear statistics
+    SET_TIME,       // User adjusting RTC via buttons
+    STOPWATCH,      // Stopwatch with laps logged to EEPROM
+    STATE_COUNT     // Number of states (keep last)
+};
+
+// Inputs that drive the FSM
+enum SystemEvent {
+    EV_USER_BUTTON,      // Onboard button: log a timestamp / stopwatch lap
+    EV_DISPLAY_BUTTON,   // Button 1: next view
+    EV_CYCLE_BUTTON,     // Button 2: next field / scroll older
+    EV_INCREMENT_BUTTON, // Button 3: increment field / scroll newer
+    EV_SAVE_DONE,        // Main loop finished writing a record
+    EVENT_COUNT          // Number of events (keep last)
+};
+
+// -----------------------------
+// Shared Clock State
+// -----------------------------
+
+// Edit and UI state written by the button ISRs and rendered by the main loop
+struct ClockState {
+    SystemState state;
+    int selectedField;            // Which time field is selected (0 = hours, 1 = mins, 2 = secs)
+    time_t rawTime;               // Current system time
+    time_t selectedTime;          // Used when adjusting RTC time
+    int historyOffset;            // Age of the newest record shown in PREV_TIMES
+    bool timeIsDirty;             // RTC update required
+    bool stopwatchRunning;
+    uint64_t stopwatchStartUs;    // Ticker time the current run segment started
+    uint64_t stopwatchBaseUs;     // Elapsed time banked by earlier segments
+    uint64_t lastLapUs;           // Elapsed time at the previous lap
+    int lapCount;
 };
-SystemState state = DISPLAY_TIME;
+
+SeqLock<ClockState> clockState(ClockState{DISPLAY_TIME, 0, 0, 0, 0, false, false, 0, 0, 0, 0});
+
+// Update the shared state from thread context
+template <typename F>
+void UpdateClockState(F update) {
+    CriticalSectionLock lock;
+    clockState.Write(update);
+}
+
+// -----------------------------
+// Code Placement & Cycle Counters
+// -----------------------------
+
+// Latency-critical code is copied to SRAM at startup (as part of .data) and
+// runs there with zero wait states, so ISR and frame timing no longer depend
+// on flash wait states and ART cache hits. The F429's 64 KB CCM is wired to
+// the D-bus only and cannot execute code, so SRAM is the only option. Only
+// GCC_ARM places these; Arm Compiler builds need a matching scatter-file
+// entry and otherwise keep the code in flash.
+//
+// Mbed OS 6 programs the MPU to make RAM execute-never, so main() takes a
+// permanent RAM execution lock before anything can call a RAM_FUNC. That is
+// preferred over platform.use-mpu: false because flash stays write-protected
+// and the exemption is visible in the code that needs it.
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+#define RAM_FUNC __attribute__((section(".data.ramfunc"), noinline, long_call))
+#else
+#define RAM_FUNC
+#endif
+
+#include "Framebuffer.h" // After RAM_FUNC, which places the blitters
+#include "Screens.h" // and the formatters
+
+// Min/max of a code path measured with the DWT cycle counter; max - min is
+// the jitter seen on target (tools/cyclemodel estimates the flash fetch part
+// of it that RAM_FUNC placement removes)
+struct CycleStats {
+    uint32_t min;
+    uint32_t max;
+
+    void Add(uint32_t cycles) {
+        if (min == 0 || cycles < min) min = cycles;
+        if (cycles > max) max = cycles;
+    }
+};
+
+CycleStats dispatchCycles;        // Button ISR body (FSM dispatch)
+CycleStats frameCycles;           // One main-loop frame render
+
+void CycleCounterInit() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+// -----------------------------
+// Frequency Governor
+// -----------------------------
+
+// Switches HCLK between 180 MHz and 90 MHz by changing only the AHB
+// prescaler, leaving the PLL locked. The APB prescalers move the opposite
+// way, so PCLK1 stays at 45 MHz (I2C3, TIM5 us_ticker at 90 MHz) and PCLK2
+// at 90 MHz (USART1 console) and their dividers remain valid. Flash wait
+// states, the SDRAM refresh count (FMC clock = HCLK / 2) and SysTick follow
+// the new HCLK, and I2C timing is re-applied.
+enum ClockSpeed {
+    CLOCK_LOW,                    // 90 MHz: idle clock display
+    CLOCK_HIGH                    // 180 MHz: browsing, editing, saving, export
+};
+
+#define SDRAM_REFRESH_COUNT_HIGH 1386 // 15.6 µs at 90 MHz SDCLK (BSP value)
+#define SDRAM_REFRESH_COUNT_LOW 683   // 15.6 µs at 45 MHz SDCLK
+
+ClockSpeed clockSpeed = CLOCK_HIGH; // Mbed boots the F429 at 180 MHz
+int governorHold = GOVERNOR_HOLD_FRAMES; // Frames left before the governor may slow down
+
+void SetSdramRefresh(uint32_t count) {
+    FMC_Bank5_6->SDRTR = (FMC_Bank5_6->SDRTR & ~FMC_SDRTR_COUNT) | (count << 1);
+}
+
+void SetClockSpeed(ClockSpeed speed) {
+    if (speed == clockSpeed) return;
+
+    uint32_t oldHz = SystemCoreClock;
+    {
+        CriticalSectionLock lock;
+        uint32_t cfgr = RCC->CFGR & ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2);
+
+        if (speed == CLOCK_HIGH) {
+            // More wait states before speeding up; refresh count once SDCLK is fast
+            FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | FLASH_ACR_LATENCY_5WS;
+            while ((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_5WS) {}
+            RCC->CFGR = cfgr | RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2;
+            SetSdramRefresh(SDRAM_REFRESH_COUNT_HIGH);
+        } else {
+            // Refresh more often before SDCLK slows; fewer wait states once HCLK is slow
+            SetSdramRefresh(SDRAM_REFRESH_COUNT_LOW);
+            RCC->CFGR = cfgr | RCC_CFGR_HPRE_DIV2 | RCC_CFGR_PPRE1_DIV2 | RCC_CFGR_PPRE2_DIV1;
+            FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | FLASH_ACR_LATENCY_2WS;
+        }
+
+        SystemCoreClockUpdate();
+        clockSpeed = speed;
+
+        // Keep the kernel tick rate if it runs from SysTick (non-tickless builds)
+        if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) {
+            SysTick->LOAD = (uint32_t)((uint64_t)(SysTick->LOAD + 1) * SystemCoreClock / oldHz) - 1;
+        }
+    }
+
+    i2c.frequency(I2C_FREQUENCY);
+}
+
+// Called once per frame: busy states run fast, the plain clock display
+// drops to the low clock after a hold-off so bursts of saves stay fast
+void GovernorUpdate(SystemState state) {
+    if (state == DISPLAY_TIME || state == DIAGNOSTICS) {
+        if (governorHold > 0 && --governorHold == 0) SetClockSpeed(CLOCK_LOW);
+    } else {
+        governorHold = GOVERNOR_HOLD_FRAMES;
+        SetClockSpeed(CLOCK_HIGH);
+    }
+}
+
+// Run at full speed now and for the hold-off period (e.g. a USB export)
+void GovernorBoost() {
+    governorHold = GOVERNOR_HOLD_FRAMES;
+    SetClockSpeed(CLOCK_HIGH);
+}
+
+// -----------------------------
+// Endurance Telemetry Counters
+// -----------------------------
+
+Telemetry telemetry;              // Counted by EEPROM::Write, checkpointed by LogStorage
+
+// -----------------------------
+// I2C Transactions
+// -----------------------------
+
+// Builds a composite bus operation from write and read segments and runs it
+// as one transaction: a single START, consecutive segments of the same
+// direction gathered/scattered without copying, a repeated START wherever
+// the direction changes (or Restart() is requested), and one STOP.
+//
+//   I2CTransaction txn(i2c, EEPROM_ADDR);
+//   txn.Write(addr, 2).Read(data, size);
+//   bool ok = txn.Execute();
+class I2CTransaction {
+public:
+    static const int MAX_SEGMENTS = 4;
+    static uint32_t count;        // Transactions executed since boot
+
+    I2CTransaction(I2C& bus, int address) : bus(bus), address(address), segments(0), restart(false) {}
+
+    I2CTransaction& Write(const char* data, int size) {
+        return Add((char*)data, size, false);
+    }
+
+    I2CTransaction& Read(char* data, int size) {
+        return Add(data, size, true);
+    }
+
+    // Force a repeated START before the next segment even if the direction is unchanged
+    I2CTransaction& Restart() {
+        restart = true;
+        return *this;
+    }
+
+    // Run all segments; returns false if the device NACKed
+    bool Execute() {
+        bool ok = true;
+
+        bus.lock();
+        for (int i = 0; ok && i < segments; i++) {
+            const Segment& seg = segment[i];
+
+            if (i == 0 || seg.restart || seg.read != segment[i - 1].read) {
+                bus.start();
+                ok = bus.write(address | (seg.read ? 1 : 0)) == 1;
+            }
+
+            for (int b = 0; ok && b < seg.size; b++) {
+                if (seg.read) {
+                    // NACK the last byte of a read phase so the device releases SDA
+                    bool last = b == seg.size - 1 &&
+                                (i + 1 == segments || !segment[i + 1].read || segment[i + 1].restart);
+                    seg.data[b] = (char)bus.read(last ? 0 : 1);
+                } else {
+                    ok = bus.write(seg.data[b]) == 1;
+                }
+            }
+        }
+        bus.stop();
+        bus.unlock();
+
+        count++;
+        return ok;
+    }
+
+private:
+    struct Segment {
+        char* data;
+        int size;
+        bool read;
+        bool restart;
+    };
+
+    I2C& bus;
+    int address;                  // 8-bit device address (R/W bit clear)
+    Segment segment[MAX_SEGMENTS];
+    int segments;
+    bool restart;
+
+    I2CTransaction& Add(char* data, int size, bool read) {
+        MBED_ASSERT(segments < MAX_SEGMENTS);
+        if (size > 0) {
+            segment[segments].data = data;
+            segment[segments].size = size;
+            segment[segments].read = read;
+            segment[segments].restart = restart;
+            segments++;
+            restart = false;
+        }
+        return *this;
+    }
+};
+
+uint32_t I2CTransaction::count = 0;
 
 // -----------------------------
 // EEPROM Helper Class
 // -----------------------------
 class EEPROM {
 public:
-    // Write data to EEPROM at given address
+    // Write data to EEPROM at given address (address bytes and data gathered into one transaction)
     static void Write(int address, unsigned int eeaddress, const char* data, int size) {
-        char buffer[size + 2];
-        buffer[0] = (unsigned char)(eeaddress >> 8); // High byte
-        buffer[1] = (unsigned char)(eeaddress & 0xFF); // Low byte
-        memcpy(&buffer[2], data, size);
+        char buffer[2] = {
+            (char)(eeaddress >> 8),   // High byte
+            (char)(eeaddress & 0xFF)  // Low byte
+        };
 
-        i2c.write(address, buffer, size + 2, false);
+        I2CTransaction txn(i2c, address);
+        txn.Write(buffer, 2).Write(data, size);
+
+        if (txn.Execute()) {
+            // The address counter rolls over within the page during a page write
+            unsigned page = eeaddress & ~(unsigned)(EEPROM_PAGE_SIZE - 1);
+            Track(address, page + (eeaddress + size) % EEPROM_PAGE_SIZE);
+        } else {
+            Track(address, -1);
+        }
+        telemetry.CountWrite(eeaddress, size);
         thread_sleep_for(6); // Write cycle delay
     }
 
-    // Read data from EEPROM at given address
+    // Read data from EEPROM at given address. The device keeps an internal
+    // address counter that points just past the last byte accessed; when the
+    // request continues from there the address phase is skipped entirely
+    // ("current address read"), otherwise the address is set and the read
+    // follows after a repeated start in the same transaction.
     static void Read(int address, unsigned int eeaddress, char* data, int size) {
+        eeaddress %= EEPROM_SIZE;
         char buffer[2] = {
-            (unsigned char)(eeaddress >> 8),
-            (unsigned char)(eeaddress & 0xFF)
+            (char)(eeaddress >> 8),
+            (char)(eeaddress & 0xFF)
         };
 
-        i2c.write(address, buffer, 2, false);
-        thread_sleep_for(6);
-        i2c.read(address, data, size);
-        thread_sleep_for(6);
+        I2CTransaction txn(i2c, address);
+        if (address != pointerDevice || (int)eeaddress != pointer) txn.Write(buffer, 2);
+        txn.Read(data, size);
+
+        Track(address, txn.Execute() ? (int)((eeaddress + size) % EEPROM_SIZE) : -1);
+    }
+
+private:
+    static int pointerDevice;     // Device whose address counter is tracked
+    static int pointer;           // Its internal address counter, -1 when unknown
+
+    static void Track(int address, int eeaddress) {
+        pointerDevice = address;
+        pointer = eeaddress;
+    }
+};
+
+int EEPROM::pointerDevice = -1;
+int EEPROM::pointer = -1;
+
+// -----------------------------
+// Hardware CRC
+// -----------------------------
+
+// Word-wise CRC-32 on the CRC peripheral; matches SoftCrc32() bit for bit.
+// Record checksums reset the unit every two words, so feeding it by DMA
+// would cost more in stream setup than it saves and is not used.
+uint32_t HwCrc32(const uint32_t* words, int count) {
+    CRC->CR = CRC_CR_RESET;
+    for (int i = 0; i < count; i++) CRC->DR = words[i];
+    return CRC->DR;
+}
+
+void HwCrcInit() {
+    RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+    (void)RCC->AHB1ENR; // Let the clock enable settle
+}
+
+uint32_t crcVerifyHwUs = 0;       // Whole-log verify time, hardware CRC
+uint32_t crcVerifySwUs = 0;       // Whole-log verify time, software CRC
+
+// Time verifying LOG_CAPACITY records with each CRC path. One block is
+// read from the ring and checked repeatedly so the bus is not involved.
+void BenchmarkRecordCrc() {
+    const int BLOCK_RECORDS = 32;
+    LogRecord block[BLOCK_RECORDS];
+    volatile int valid = 0;       // Keep the loops from being optimized away
+
+    EEPROM::Read(EEPROM_ADDR, LogSlotAddress(0), (char*)block, sizeof(block));
+
+    uint32_t start = DWT->CYCCNT;
+    for (int n = 0; n < LOG_CAPACITY; n++) valid += block[n % BLOCK_RECORDS].check == RecordCrc(block[n % BLOCK_RECORDS], 0);
+    uint32_t hwCycles = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    for (int n = 0; n < LOG_CAPACITY; n++) valid += block[n % BLOCK_RECORDS].check == RecordCrcSoft(block[n % BLOCK_RECORDS], 0);
+    uint32_t swCycles = DWT->CYCCNT - start;
+
+    crcVerifyHwUs = hwCycles / (SystemCoreClock / 1000000);
+    crcVerifySwUs = swCycles / (SystemCoreClock / 1000000);
+    printf("Verify %d records: hw CRC %lu us, sw CRC %lu us\n", LOG_CAPACITY,
+           (unsigned long)crcVerifyHwUs, (unsigned long)crcVerifySwUs);
+}
+
+// -----------------------------
+// Endurance Telemetry
+// -----------------------------
+
+uint32_t UptimeSeconds() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::seconds>(Kernel::Clock::now().time_since_epoch()).count();
+}
+
+// Format one line of the wear report; returns false past the last line
+bool TelemetryLine(int line, char* out) {
+    if (WearLine(telemetry, telemetry.baseSeconds + UptimeSeconds(), line, out)) return true;
+
+    switch (line) {
+        case 7: sprintf(out, "I2C txns %lu", (unsigned long)I2CTransaction::count); return true;
+        case 8: sprintf(out, "Seq retry %lu", (unsigned long)clockState.Retries()); return true;
+        case 9: sprintf(out, "ISR %lu-%lu cy", (unsigned long)dispatchCycles.min, (unsigned long)dispatchCycles.max); return true;
+        case 10: sprintf(out, "Frm %lu-%lu kc", (unsigned long)(frameCycles.min / 1000), (unsigned long)(frameCycles.max / 1000)); return true;
+        case 11: sprintf(out, "CPU %lu MHz", (unsigned long)(SystemCoreClock / 1000000)); return true;
+        case 12: sprintf(out, "CRC %lu/%lu us", (unsigned long)crcVerifyHwUs, (unsigned long)crcVerifySwUs); return true;
+        default: return false;
+    }
+}
+
+// -----------------------------
+// EEPROM Page Cache
+// -----------------------------
+
+// Small LRU cache of whole EEPROM pages. Reads that hit are served from RAM;
+// writes go straight to the device and update any cached copy.
+struct CachedPage {
+    int page;                     // Page number, -1 when unused
+    uint32_t lastUse;             // LRU timestamp
+    char data[EEPROM_PAGE_SIZE];
+};
+
+CachedPage pageCache[CACHE_PAGES];
+uint32_t cacheClock = 0;
+
+void CacheInit() {
+    for (int i = 0; i < CACHE_PAGES; i++) pageCache[i].page = -1;
+}
+
+CachedPage* CacheLookup(int page) {
+    for (int i = 0; i < CACHE_PAGES; i++) {
+        if (pageCache[i].page == page) return &pageCache[i];
+    }
+    return NULL;
+}
+
+// Load a page into the least recently used entry
+CachedPage* CacheFill(int page) {
+    CachedPage* victim = &pageCache[0];
+    for (int i = 1; i < CACHE_PAGES; i++) {
+        if (pageCache[i].lastUse < victim->lastUse) victim = &pageCache[i];
+    }
+
+    EEPROM::Read(EEPROM_ADDR, page * EEPROM_PAGE_SIZE, victim->data, EEPROM_PAGE_SIZE);
+    victim->page = page;
+    victim->lastUse = cacheClock;
+    return victim;
+}
+
+// Copy bytes that lie within a single page, loading the page on a miss
+void CacheRead(unsigned eeaddress, char* data, int size) {
+    int page = eeaddress / EEPROM_PAGE_SIZE;
+    CachedPage* entry = CacheLookup(page);
+    if (!entry) entry = CacheFill(page);
+
+    entry->lastUse = ++cacheClock;
+    memcpy(data, &entry->data[eeaddress % EEPROM_PAGE_SIZE], size);
+}
+
+// Keep a cached page coherent with a write that lies within it
+void CacheWrite(unsigned eeaddress, const char* data, int size) {
+    CachedPage* entry = CacheLookup(eeaddress / EEPROM_PAGE_SIZE);
+    if (entry) memcpy(&entry->data[eeaddress % EEPROM_PAGE_SIZE], data, size);
+}
+
+// -----------------------------
+// Log Storage
+// -----------------------------
+
+// The log ring, presence index and telemetry checkpoints (LogStorage.h) run
+// on the I2C driver; record reads go through the page cache and every write
+// keeps any cached copy of its page coherent.
+struct EepromBackend {
+    void Write(unsigned eeaddress, const void* data, int size) {
+        EEPROM::Write(EEPROM_ADDR, eeaddress, (const char*)data, size);
+        CacheWrite(eeaddress, (const char*)data, size);
+    }
+
+    void Read(unsigned eeaddress, void* data, int size) {
+        EEPROM::Read(EEPROM_ADDR, eeaddress, (char*)data, size);
+    }
+
+    void ReadCached(unsigned eeaddress, void* data, int size) {
+        CacheRead(eeaddress, (char*)data, size);
+    }
+
+    uint32_t UptimeSeconds() { return ::UptimeSeconds(); }
+};
+
+EepromBackend eepromBackend;
+LogStorage<EepromBackend> storage(eepromBackend, telemetry);
+
+// -----------------------------
+// History Prefetch
+// -----------------------------
+
+// Tracks which way the history window last moved and, during idle time,
+// pulls the pages just beyond its leading edge into the cache so the next
+// scroll step never waits on the bus.
+int prefetchEdge = 0;             // Age of the record at the window's leading edge
+int prefetchDir = 1;              // +1 = browsing older, -1 = browsing newer
+int lastHistoryOffset = 0;
+
+void PrefetchTrack(int offset) {
+    if (offset > lastHistoryOffset) prefetchDir = 1;
+    else if (offset < lastHistoryOffset) prefetchDir = -1;
+    lastHistoryOffset = offset;
+
+    prefetchEdge = (prefetchDir > 0) ? offset + HISTORY_ROWS - 1 : offset;
+}
+
+// Fetch at most one missing page per call to bound main-loop latency
+void PrefetchIdle() {
+    const int RECORDS_PER_PAGE = EEPROM_PAGE_SIZE / LOG_RECORD_SIZE;
+
+    for (int k = 1; k <= PREFETCH_DEPTH; k++) {
+        int age = prefetchEdge + prefetchDir * k * RECORDS_PER_PAGE;
+        if (age < 0 || age >= storage.logCount) return;
+
+        int slot = (storage.logHead - 1 - age + LOG_CAPACITY) % LOG_CAPACITY;
+        int page = LogSlotAddress(slot) / EEPROM_PAGE_SIZE;
+        if (!CacheLookup(page)) {
+            CacheFill(page);
+            return;
+        }
+    }
+}
+
+// -----------------------------
+// RTC Second Anchor
+// -----------------------------
+
+// The RTC only counts whole seconds and the us_ticker has no wall time, so
+// lap times are placed from one pair of readings: the ticker at an RTC
+// second edge, caught by a single alarm B interrupt, and the second that
+// edge started. Every lap of a run uses the same pair, so splits in the log
+// match lapHistory; absolute times drift from the RTC by the tolerance of
+// the ticker's crystal, so an idle anchor is renewed between runs.
+#define ANCHOR_REFRESH_US 600000000ULL // Renew an idle anchor after 10 minutes
+
+enum AnchorState {
+    ANCHOR_NONE,                  // Never requested
+    ANCHOR_ARMED,                 // Waiting for the alarm B edge
+    ANCHOR_LATCHED,               // Edge caught, second not yet known
+    ANCHOR_READY,
+};
+
+volatile AnchorState anchorState = ANCHOR_NONE;
+volatile uint64_t anchorTickerUs = 0; // us_ticker at the edge
+uint32_t anchorEpoch = 0;         // RTC second the edge started
+
+// Arm alarm B with every field masked, so it fires at the next second edge.
+// The alarm interrupt writes RTC->CR too, hence the critical section.
+void AnchorRequest() {
+    CriticalSectionLock lock;
+    anchorState = ANCHOR_ARMED;
+    PWR->CR |= PWR_CR_DBP;
+    RTC->WPR = 0xCA;
+    RTC->WPR = 0x53;
+    RTC->CR &= ~(RTC_CR_ALRBE | RTC_CR_ALRBIE);
+    while (!(RTC->ISR & RTC_ISR_ALRBWF)) {} // Two RTCCLK cycles at most
+
+    RTC->ALRMBR = RTC_ALRMBR_MSK4 | RTC_ALRMBR_MSK3 | RTC_ALRMBR_MSK2 | RTC_ALRMBR_MSK1;
+    RTC->ISR = ~(RTC_ISR_ALRBF | RTC_ISR_INIT) & 0xFFFF; // Flags clear on writing 0
+    RTC->CR |= RTC_CR_ALRBE | RTC_CR_ALRBIE;
+    RTC->WPR = 0xFF;
+}
+
+// Alarm B interrupt: latch the edge and stop the alarm
+RAM_FUNC void AnchorLatch() {
+    anchorTickerUs = ticker_read_us(get_us_ticker_data());
+    RTC->WPR = 0xCA;
+    RTC->WPR = 0x53;
+    RTC->CR &= ~(RTC_CR_ALRBE | RTC_CR_ALRBIE);
+    RTC->WPR = 0xFF;
+    anchorState = ANCHOR_LATCHED;
+}
+
+// Once per frame: pair a latched edge with its second, or renew the anchor
+// while no stopwatch run depends on it. time(NULL) cannot be called from the
+// interrupt, and read here it is ambiguous right next to an edge, so the
+// pairing waits for a frame that falls well inside a second.
+void AnchorUpdate(const ClockState& snapshot) {
+    if (anchorState == ANCHOR_LATCHED) {
+        uint32_t now = (uint32_t)time(NULL);
+        uint64_t since = ticker_read_us(get_us_ticker_data()) - anchorTickerUs;
+        uint32_t fraction = (uint32_t)(since % 1000000);
+        if (fraction > 10000 && fraction < 990000) {
+            anchorEpoch = now - (uint32_t)(since / 1000000);
+            anchorState = ANCHOR_READY;
+        }
+    } else if (anchorState == ANCHOR_READY && !snapshot.stopwatchRunning && snapshot.lapCount == 0 &&
+               ticker_read_us(get_us_ticker_data()) - anchorTickerUs > ANCHOR_REFRESH_US) {
+        AnchorRequest();
+    }
+}
+
+// -----------------------------
+// Alarm Scheduler
+// -----------------------------
+
+// Active alarms sit in a hierarchical timer wheel: level L has WHEEL_SLOTS
+// slots of 64^L seconds each, and an alarm goes in the lowest level whose
+// range reaches its deadline. Insert, remove and finding the next event are
+// O(1) (bitmap scan per level), and entries only move down a level when their
+// slot comes up. The RTC alarm is programmed for the next event alone, so the
+// CPU is not woken for alarms that are not yet due.
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define ALARM_NONE 0xFF           // End of a wheel slot list
+#define NO_DEADLINE 0xFFFFFFFFUL
+
+AlarmEntry alarms[ALARM_SLOTS];   // RAM copy of the EEPROM alarm table
+uint32_t alarmDue[ALARM_SLOTS];   // Next deadline of each active alarm
+uint8_t alarmNext[ALARM_SLOTS];   // Link to the next alarm in the same wheel slot
+int16_t alarmWhere[ALARM_SLOTS];  // level * WHEEL_SLOTS + slot, -1 when not queued
+uint8_t wheel[WHEEL_LEVELS][WHEEL_SLOTS]; // First alarm of each slot
+uint64_t wheelUsed[WHEEL_LEVELS]; // Bit per non-empty slot
+uint32_t wheelNow = 0;            // Time up to which the wheel has been advanced
+uint32_t alarmArmed = NO_DEADLINE; // Deadline programmed into the RTC alarm
+volatile bool alarmPending = false; // Set by the RTC alarm interrupt
+
+void WheelInsert(int i) {
+    uint32_t due = alarmDue[i] > wheelNow ? alarmDue[i] : wheelNow;
+
+    int level = 0;
+    while (level < WHEEL_LEVELS - 1 &&
+           (due >> (level * WHEEL_BITS)) - (wheelNow >> (level * WHEEL_BITS)) >= WHEEL_SLOTS) level++;
+
+    // Deadlines beyond the top level wait in its farthest slot and are re-placed from there
+    uint32_t block = due >> (level * WHEEL_BITS);
+    uint32_t limit = (wheelNow >> (level * WHEEL_BITS)) + WHEEL_SLOTS - 1;
+    int slot = (block < limit ? block : limit) & (WHEEL_SLOTS - 1);
+
+    alarmNext[i] = wheel[level][slot];
+    wheel[level][slot] = i;
+    wheelUsed[level] |= 1ULL << slot;
+    alarmWhere[i] = level * WHEEL_SLOTS + slot;
+}
+
+void WheelRemove(int i) {
+    if (alarmWhere[i] < 0) return;
+    int level = alarmWhere[i] / WHEEL_SLOTS;
+    int slot = alarmWhere[i] % WHEEL_SLOTS;
+
+    uint8_t* link = &wheel[level][slot];
+    while (*link != i) link = &alarmNext[*link];
+    *link = alarmNext[i];
+    if (wheel[level][slot] == ALARM_NONE) wheelUsed[level] &= ~(1ULL << slot);
+    alarmWhere[i] = -1;
+}
+
+// Detach a whole slot list and return its first alarm
+uint8_t WheelTake(int level, int slot) {
+    uint8_t first = wheel[level][slot];
+    wheel[level][slot] = ALARM_NONE;
+    wheelUsed[level] &= ~(1ULL << slot);
+    for (uint8_t i = first; i != ALARM_NONE; i = alarmNext[i]) alarmWhere[i] = -1;
+    return first;
+}
+
+// Time of the earliest non-empty slot: a deadline on level 0, a cascade point above
+uint32_t WheelNextEvent() {
+    uint32_t next = NO_DEADLINE;
+
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        uint64_t used = wheelUsed[level];
+        if (!used) continue;
+
+        int shift = level * WHEEL_BITS;
+        int current = (wheelNow >> shift) & (WHEEL_SLOTS - 1);
+        uint64_t ahead = current ? (used >> current) | (used << (WHEEL_SLOTS - current)) : used;
+        uint32_t when = ((wheelNow >> shift) + __builtin_ctzll(ahead)) << shift;
+
+        if (when < wheelNow) when = wheelNow;
+        if (when < next) next = when;
+    }
+    return next;
+}
+
+// Persist one alarm slot (a single 8-byte write within one page)
+void AlarmStore(int i) {
+    alarms[i].check = AlarmCrc(alarms[i]);
+    EEPROM::Write(EEPROM_ADDR, AlarmAddress(i), (const char*)&alarms[i], sizeof(AlarmEntry));
+}
+
+void AlarmDelete(int i) {
+    WheelRemove(i);
+    memset(&alarms[i], 0, sizeof(AlarmEntry));
+    AlarmStore(i);
+}
+
+// Log the firing and queue the next occurrence (one-shots are deleted)
+void AlarmFire(int i) {
+    LogRecord record = {};
+    record.epoch = alarmDue[i];
+    record.tag = LOG_CHANNEL_ALARM;
+    storage.LogAppend(record);
+
+    char timebuff[20];
+    FormatRecordTime(record, timebuff);
+    if (usbSerial.connected()) usbSerial.printf("Alarm %d at %s\r\n", i, timebuff);
+
+    if (alarms[i].period == 0) {
+        AlarmDelete(i);
+        return;
+    }
+    alarmDue[i] = AlarmNextDeadline(alarms[i], wheelNow + 1);
+    WheelInsert(i);
+}
+
+// Run every alarm due by now, jumping straight between events
+void AlarmAdvance(uint32_t now) {
+    for (uint32_t when = WheelNextEvent(); when <= now; when = WheelNextEvent()) {
+        wheelNow = when;
+
+        for (int level = WHEEL_LEVELS - 1; level > 0; level--) { // Cascade slots starting now
+            int shift = level * WHEEL_BITS;
+            if (wheelNow & ((1UL << shift) - 1)) continue;
+
+            uint8_t i = WheelTake(level, (wheelNow >> shift) & (WHEEL_SLOTS - 1));
+            while (i != ALARM_NONE) {
+                uint8_t next = alarmNext[i];
+                WheelInsert(i);
+                i = next;
+            }
+        }
+
+        uint8_t i = WheelTake(0, wheelNow & (WHEEL_SLOTS - 1));
+        while (i != ALARM_NONE) {
+            uint8_t next = alarmNext[i];
+            AlarmFire(i);
+            i = next;
+        }
+        wheelNow++;
     }
+    if (now > wheelNow) wheelNow = now;
+}
+
+uint8_t Bcd(int value) {
+    return (uint8_t)(((value / 10) << 4) | (value % 10));
+}
+
+// Program RTC alarm A to match the deadline's date and time of day. A
+// deadline a month or more away can match early; the wakeup then finds
+// nothing due and AlarmService reprograms. A deadline that is already due,
+// or passes while the alarm is disabled here, would not match until next
+// month, so it is flagged as pending instead.
+void RtcAlarmProgram(uint32_t deadline) {
+    CriticalSectionLock lock; // The alarm interrupt unlocks and relocks RTC->WPR
+    PWR->CR |= PWR_CR_DBP;
+    RTC->WPR = 0xCA;
+    RTC->WPR = 0x53;
+    RTC->CR &= ~(RTC_CR_ALRAE | RTC_CR_ALRAIE);
+    while (!(RTC->ISR & RTC_ISR_ALRAWF)) {}
+
+    if (deadline != NO_DEADLINE) {
+        time_t when = deadline;
+        struct tm* t = gmtime(&when); // The RTC calendar holds UTC
+        RTC->ALRMAR = ((uint32_t)Bcd(t->tm_mday) << 24) | ((uint32_t)Bcd(t->tm_hour) << 16) |
+                      ((uint32_t)Bcd(t->tm_min) << 8) | Bcd(t->tm_sec);
+        RTC->ISR = ~(RTC_ISR_ALRAF | RTC_ISR_INIT) & 0xFFFF; // Flags clear on writing 0
+        RTC->CR |= RTC_CR_ALRAE | RTC_CR_ALRAIE;
+    }
+    RTC->WPR = 0xFF;
+    alarmArmed = deadline;
+    if ((uint32_t)time(NULL) >= deadline) alarmPending = true;
+}
+
+// Alarm A is the scheduler's deadline, alarm B the second-anchor edge
+RAM_FUNC void RtcAlarmIrq() {
+    uint32_t flags = RTC->ISR;
+    if (flags & RTC_ISR_ALRBF) {
+        RTC->ISR = ~(RTC_ISR_ALRBF | RTC_ISR_INIT) & 0xFFFF; // Flags clear on writing 0
+        AnchorLatch();
+    }
+    if (flags & RTC_ISR_ALRAF) {
+        RTC->ISR = ~(RTC_ISR_ALRAF | RTC_ISR_INIT) & 0xFFFF;
+        alarmPending = true;
+    }
+    EXTI->PR = EXTI_PR_PR17;
+}
+
+// Fire due alarms and re-arm the RTC for the next event. After a wakeup the
+// alarm is always rewritten, so an early match is cleared and retried.
+void AlarmService() {
+    bool woken = alarmPending;
+    alarmPending = false;
+    AlarmAdvance((uint32_t)time(NULL));
+
+    uint32_t next = WheelNextEvent();
+    if (woken || next != alarmArmed) RtcAlarmProgram(next);
+}
+
+// Rebuild the wheel around the current time (at boot and after the clock is set)
+void AlarmReschedule() {
+    memset(wheel, ALARM_NONE, sizeof(wheel));
+    memset(wheelUsed, 0, sizeof(wheelUsed));
+    wheelNow = (uint32_t)time(NULL);
+
+    for (int i = 0; i < ALARM_SLOTS; i++) {
+        alarmWhere[i] = -1;
+        if (!AlarmIsValid(alarms[i])) continue;
+        alarmDue[i] = AlarmNextDeadline(alarms[i], wheelNow);
+        WheelInsert(i);
+    }
+    AlarmService();
+}
+
+// Load the alarm table and route the RTC alarm interrupt
+void AlarmInit() {
+    EEPROM::Read(EEPROM_ADDR, ALARM_BASE, (char*)alarms, sizeof(alarms));
+
+    EXTI->IMR |= EXTI_IMR_MR17;   // EXTI line 17 is the RTC alarm
+    EXTI->RTSR |= EXTI_RTSR_TR17;
+    NVIC_SetVector(RTC_Alarm_IRQn, (uint32_t)&RtcAlarmIrq);
+    NVIC_EnableIRQ(RTC_Alarm_IRQn);
+
+    AlarmReschedule();
+}
+
+// Register an alarm in a free slot; returns the slot or -1 when the table is full
+int AlarmAdd(uint32_t anchor, uint16_t periodMinutes) {
+    for (int i = 0; i < ALARM_SLOTS; i++) {
+        if (AlarmIsValid(alarms[i])) continue;
+
+        alarms[i].anchor = anchor;
+        alarms[i].period = periodMinutes;
+        alarms[i].flags = ALARM_ACTIVE;
+        AlarmStore(i);
+
+        alarmDue[i] = AlarmNextDeadline(alarms[i], wheelNow);
+        WheelInsert(i);
+        AlarmService(); // Re-arm if this is now the earliest
+        return i;
+    }
+    return -1;
+}
+
+// -----------------------------
+// Stopwatch
+// -----------------------------
+
+// Laps are timestamped in the button ISR from the 1 MHz us_ticker and
+// queued in RAM; the main loop writes them to the log afterwards, so a lap
+// is never delayed by an EEPROM write in progress. The queue has a single
+// producer (FSM actions) and a single consumer (the main loop).
+struct LapEvent {
+    uint64_t tickerUs;            // us_ticker time of the press
+    uint64_t elapsedUs;           // Stopwatch reading at the press
+    uint64_t splitUs;             // Time since the previous lap
+    int lap;                      // 1-based lap number within the run
 };
 
+LapEvent lapQueue[LAP_QUEUE];
+volatile uint32_t lapQueueHead = 0; // Written by the producer only
+volatile uint32_t lapQueueTail = 0; // Written by the consumer only
+uint32_t lapsDropped = 0;         // Laps lost to a full queue
+
+LapEvent lapHistory[LAP_HISTORY]; // Recent laps, indexed by (lap - 1) % LAP_HISTORY
+int lapsRecorded = 0;             // Number of the newest lap in lapHistory
+
+RAM_FUNC uint64_t StopwatchNowUs() {
+    return ticker_read_us(get_us_ticker_data());
+}
+
+RAM_FUNC uint64_t StopwatchElapsed(const ClockState& s, uint64_t nowUs) {
+    return s.stopwatchRunning ? s.stopwatchBaseUs + (nowUs - s.stopwatchStartUs) : s.stopwatchBaseUs;
+}
+
+RAM_FUNC void LapPush(const LapEvent& lap) {
+    uint32_t head = lapQueueHead;
+    if (head - lapQueueTail >= LAP_QUEUE) {
+        lapsDropped++;
+        return;
+    }
+    lapQueue[head % LAP_QUEUE] = lap;
+    __DMB(); // Publish the entry before the index
+    lapQueueHead = head + 1;
+}
+
+// Log queued laps at their captured wall-clock time, placed from the RTC
+// second anchor: splits read back from the log match lapHistory to the
+// nearest 1/65536 s. Laps wait in the queue while the anchor is being
+// (re)taken, which is about a second after boot or a clock change.
+void LapDrain() {
+    if (lapQueueTail == lapQueueHead || anchorState != ANCHOR_READY) return;
+
+    while (lapQueueTail != lapQueueHead) {
+        __DMB();
+        LapEvent lap = lapQueue[lapQueueTail % LAP_QUEUE];
+        lapQueueTail = lapQueueTail + 1;
+
+        uint64_t lapWallUs = (uint64_t)anchorEpoch * 1000000 + (int64_t)(lap.tickerUs - anchorTickerUs);
+        uint32_t ticks = (uint32_t)(((lapWallUs % 1000000) * 65536 + 500000) / 1000000); // Rounded, may carry
+        LogRecord record = {};
+        record.epoch = (uint32_t)(lapWallUs / 1000000) + (ticks >> 16);
+        record.subsecond = (uint16_t)ticks;
+        record.tag = LOG_CHANNEL_LAP;
+        storage.LogAppend(record);
+
+        if (lap.lap == 1) lapsRecorded = 0; // New run
+        lapHistory[(lap.lap - 1) % LAP_HISTORY] = lap;
+        lapsRecorded = lap.lap;
+    }
+}
+
 // -----------------------------
 // Function Prototypes
 // -----------------------------
 void GetTime();           // ISR: Logs time on user button press
-void DisplayTimes();      // ISR: Toggles between display/log view
-void ValueCycle();        // ISR: Cycles through fields in SET_TIME mode
-void ValueIncrement();    // ISR: Increments selected field in SET_TIME mode
+void DisplayTimes();      // ISR: Cycles time → log → diagnostics views
+void ValueCycle();        // ISR: Cycles fields in SET_TIME mode / scrolls older in PREV_TIMES
+void ValueIncrement();    // ISR: Increments field in SET_TIME mode / scrolls newer in PREV_TIMES
 void ShowTime();          // Displays current RTC time
-void ShowPreviousTimes(); // Displays last two saved times
+void ShowPreviousTimes(const ClockState& snapshot); // Displays a window of saved times
+void ShowDiagnostics();   // Displays EEPROM wear statistics
 void SaveTime();          // Saves current RTC time into EEPROM
-void SetTime();           // Displays editable RTC time
+void SetTime(const ClockState& snapshot); // Displays editable RTC time
+void ShowStopwatch(const ClockState& snapshot); // Displays stopwatch and last lap
+void PrintLaps();         // Prints recent lap splits over USB
+void ExportLog();         // Streams the log as CSV over USB
+void DumpImage();         // Streams the raw EEPROM image over USB
+void PrintMonthOverview(); // Prints the per-day activity index over USB
+void AddAlarmCommand(const char* line);    // Registers an alarm from a USB command line
+void DeleteAlarmCommand(const char* line); // Deletes an alarm by slot from a USB command line
+void ListAlarms();        // Prints active alarms over USB
+void PollUsb();           // Handles USB commands
+
+// -----------------------------
+// FSM Transition Table
+// -----------------------------
+
+// Actions run inside the clock-state write, so they see and modify one
+// consistent ClockState and must stay short.
+typedef void (*FsmAction)(ClockState& s);
+
+struct FsmTransition {
+    FsmAction action;
+    SystemState next;
+};
+
+RAM_FUNC void NoAction(ClockState&) {}
+
+// Starting a save, leaving the editor or opening the log commits pending time edits
+RAM_FUNC void CommitEdit(ClockState& s) {
+    s.timeIsDirty = true;
+}
+
+RAM_FUNC void OpenHistory(ClockState& s) {
+    s.historyOffset = 0; // Open history at the newest record
+}
+
+RAM_FUNC void CommitAndOpenHistory(ClockState& s) {
+    CommitEdit(s);
+    OpenHistory(s);
+}
+
+RAM_FUNC void BeginEdit(ClockState& s) {
+    s.selectedTime = s.rawTime;   // Start editing from current RTC time
+    s.selectedField = 0;
+}
+
+RAM_FUNC void NextField(ClockState& s) {
+    s.selectedField = (s.selectedField + 1) % 3; // Rotate through fields
+}
+
+void IncrementField(ClockState& s) {
+    struct tm* timeInfo = localtime(&s.selectedTime);
+    if (s.selectedField == 0)      timeInfo->tm_hour = (timeInfo->tm_hour + 1) % 24;
+    else if (s.selectedField == 1) timeInfo->tm_min = (timeInfo->tm_min + 1) % 60;
+    else                           timeInfo->tm_sec = (timeInfo->tm_sec + 1) % 60;
+
+    s.selectedTime = mktime(timeInfo);
+}
+
+RAM_FUNC void ScrollOlder(ClockState& s) {
+    if (s.historyOffset + 1 < storage.logCount) s.historyOffset++;
+}
+
+RAM_FUNC void ScrollNewer(ClockState& s) {
+    if (s.historyOffset > 0) s.historyOffset--;
+}
+
+// Onboard button in STOPWATCH: start when stopped, otherwise take a lap
+RAM_FUNC void StopwatchLap(ClockState& s) {
+    uint64_t now = StopwatchNowUs();
+    if (!s.stopwatchRunning) {
+        s.stopwatchStartUs = now;
+        s.stopwatchRunning = true;
+        return;
+    }
+
+    LapEvent lap;
+    lap.tickerUs = now;
+    lap.elapsedUs = StopwatchElapsed(s, now);
+    lap.splitUs = lap.elapsedUs - s.lastLapUs;
+    lap.lap = ++s.lapCount;
+    s.lastLapUs = lap.elapsedUs;
+    LapPush(lap);
+}
+
+RAM_FUNC void StopwatchToggle(ClockState& s) {
+    uint64_t now = StopwatchNowUs();
+    if (s.stopwatchRunning) s.stopwatchBaseUs += now - s.stopwatchStartUs;
+    else                    s.stopwatchStartUs = now;
+    s.stopwatchRunning = !s.stopwatchRunning;
+}
+
+RAM_FUNC void StopwatchReset(ClockState& s) {
+    s.stopwatchRunning = false;
+    s.stopwatchBaseUs = 0;
+    s.lastLapUs = 0;
+    s.lapCount = 0;
+}
+
+// state × event → (action, next state). Every cell must be filled in.
+constexpr FsmTransition fsmTable[STATE_COUNT][EVENT_COUNT] = {
+    // DISPLAY_TIME
+    { {NoAction, SAVE_TIME}, {OpenHistory, PREV_TIMES}, {BeginEdit, SET_TIME},
+      {BeginEdit, SET_TIME}, {NoAction, DISPLAY_TIME} },
+    // SAVE_TIME
+    { {NoAction, SAVE_TIME}, {OpenHistory, PREV_TIMES}, {BeginEdit, SET_TIME},
+      {BeginEdit, SET_TIME}, {NoAction, DISPLAY_TIME} },
+    // PREV_TIMES
+    { {NoAction, SAVE_TIME}, {NoAction, DIAGNOSTICS}, {ScrollOlder, PREV_TIMES},
+      {ScrollNewer, PREV_TIMES}, {NoAction, PREV_TIMES} },
+    // DIAGNOSTICS
+    { {NoAction, SAVE_TIME}, {NoAction, STOPWATCH}, {BeginEdit, SET_TIME},
+      {BeginEdit, SET_TIME}, {NoAction, DIAGNOSTICS} },
+    // SET_TIME
+    { {CommitEdit, SAVE_TIME}, {CommitAndOpenHistory, PREV_TIMES}, {NextField, SET_TIME},
+      {IncrementField, SET_TIME}, {NoAction, SET_TIME} },
+    // STOPWATCH
+    { {StopwatchLap, STOPWATCH}, {NoAction, DISPLAY_TIME}, {StopwatchToggle, STOPWATCH},
+      {StopwatchReset, STOPWATCH}, {NoAction, STOPWATCH} },
+};
+
+// Rows or cells left out of the initializer are zero-filled and caught here
+constexpr bool FsmTableComplete() {
+    for (int st = 0; st < STATE_COUNT; st++) {
+        for (int ev = 0; ev < EVENT_COUNT; ev++) {
+            if (fsmTable[st][ev].action == nullptr || fsmTable[st][ev].next >= STATE_COUNT) return false;
+        }
+    }
+    return true;
+}
+static_assert(FsmTableComplete(), "Every state must handle every event");
+
+// Constant-time dispatch: one table lookup and one indirect call.
+// Call from ISR context, or from thread context inside a critical section.
+RAM_FUNC void Dispatch(SystemEvent event) {
+    uint32_t start = DWT->CYCCNT;
+
+    clockState.Write([event](ClockState& s) {
+        const FsmTransition& t = fsmTable[s.state][event];
+        t.action(s);
+        s.state = t.next;
+    });
+
+    dispatchCycles.Add(DWT->CYCCNT - start);
+}
 
 // -----------------------------
 // Interrupt Service Routines
 // -----------------------------
 
 // Onboard button pressed → save current RTC time
-void GetTime() {
-    if (state == SET_TIME) timeIsDirty = true; // Commit user edits if needed
-    state = SAVE_TIME;
+RAM_FUNC void GetTime() {
+    Dispatch(EV_USER_BUTTON);
 }
 
-// External button pressed → toggle between Idle (current time) and Log display
-void DisplayTimes() {
-    if (state == SET_TIME) timeIsDirty = true;
-    state = (state != PREV_TIMES) ? PREV_TIMES : DISPLAY_TIME;
+// External button pressed → cycle Idle (current time) → Log display → Diagnostics → Stopwatch
+RAM_FUNC void DisplayTimes() {
+    Dispatch(EV_DISPLAY_BUTTON);
 }
 
-// External button pressed → cycle through hour/min/sec fields
-void ValueCycle() {
-    if (state != SET_TIME) {
-        state = SET_TIME;
-        selectedTime = rawTime;   // Start editing from current RTC time
-        selectedField = 0;
-    } else {
-        selectedField = (selectedField + 1) % 3; // Rotate through fields
-    }
+// External button pressed → cycle through hour/min/sec fields (scroll older in history, start/stop stopwatch)
+RAM_FUNC void ValueCycle() {
+    Dispatch(EV_CYCLE_BUTTON);
 }
 
-// External button pressed → increment currently selected field
-void ValueIncrement() {
-    if (state != SET_TIME) {
-        state = SET_TIME;
-        selectedTime = rawTime;
-        selectedField = 0;
-    } else {
-        struct tm* timeInfo = localtime(&selectedTime);
-        if (selectedField == 0)      timeInfo->tm_hour = (timeInfo->tm_hour + 1) % 24;
-        else if (selectedField == 1) timeInfo->tm_min = (timeInfo->tm_min + 1) % 60;
-        else                         timeInfo->tm_sec = (timeInfo->tm_sec + 1) % 60;
+// External button pressed → increment currently selected field (scroll newer in history, reset stopwatch)
+RAM_FUNC void ValueIncrement() {
+    Dispatch(EV_INCREMENT_BUTTON);
+}
+
+// -----------------------------
+// Screen Compositing
+// -----------------------------
+
+// Layer 1 (BSP background layer) holds the labels of the current screen and
+// is redrawn only when the screen changes. Layer 2 is an L8 palette layer
+// narrowed to a window around the dynamic text, with PALETTE_KEY shown
+// through as layer 1. The BSP only draws 16/32-bit pixels, so layer 2 is
+// rendered with the one-byte-per-pixel primitives from Framebuffer.h.
+#define LAYER_STATIC  LCD_BACKGROUND_LAYER
+#define LAYER_DYNAMIC LCD_FOREGROUND_LAYER
+#define LTDC_PIXEL_FORMAT_L8_VALUE 0x5       // LTDC LxPFCR encoding of L8
+
+uint8_t* const dynamicPixels = (uint8_t*)(LCD_FRAME_BUFFER + BUFFER_OFFSET);
+L8Frame  dynamicFrame;
+L8Font   dynamicFont;
+int      currentScreen = -1; // Screen whose labels are on the static layer
+uint16_t dynamicY = 0, dynamicHeight = 0;
+
+// Layout cache for the text lines of the dynamic window, one per font row
+#define DYNAMIC_LINES 16
+L8TextLine dynamicLines[DYNAMIC_LINES];
+
+// Both layers keep full-screen framebuffers so drawing stays in screen
+// coordinates; only the LTDC scan-out of layer 2 is cropped to the window.
+void CompositorInit() {
+    LCD.LayerDefaultInit(LAYER_STATIC, LCD_FRAME_BUFFER);
+    LCD.LayerDefaultInit(LAYER_DYNAMIC, LCD_FRAME_BUFFER + BUFFER_OFFSET);
+    LCD.SetColorKeying(LAYER_DYNAMIC, paletteRgb[PALETTE_KEY]);
+    LCD.SetLayerVisible(LAYER_STATIC, ENABLE);
 
-        selectedTime = mktime(timeInfo);
+    dynamicFrame = {dynamicPixels, (uint16_t)LCD.GetXSize(), (uint16_t)LCD.GetYSize()};
+    dynamicFont = {Font20.table, Font20.Width, Font20.Height};
+    L8Fill(dynamicFrame, 0, 0, dynamicFrame.width, dynamicFrame.height, PALETTE_KEY);
+
+    // Switch layer 2 to L8; the CLUT may only be written while the layer is off
+    LTDC_Layer2->CR &= ~LTDC_LxCR_LEN;
+    LTDC_Layer2->PFCR = LTDC_PIXEL_FORMAT_L8_VALUE;
+    for (uint32_t i = 0; i < PALETTE_SIZE; i++) {
+        LTDC_Layer2->CLUTWR = (i << 24) | paletteRgb[i];
     }
+    LTDC_Layer2->CR |= LTDC_LxCR_CLUTEN | LTDC_LxCR_LEN;
+    LTDC->SRCR = LTDC_SRCR_IMR;
+}
+
+// Program the layer 2 window directly: BSP SetLayerWindow would also shrink
+// the line pitch, and it and the other BSP layer calls (SetTransparency,
+// SetLayerAddress) reload the ARGB8888 config, undoing the L8 setup.
+void SetDynamicWindow(uint16_t y, uint16_t height) {
+    uint32_t width = dynamicFrame.width;
+    uint32_t hbp = (LTDC->BPCR & LTDC_BPCR_AHBP) >> 16;
+    uint32_t vbp = LTDC->BPCR & LTDC_BPCR_AVBP;
+
+    LTDC_Layer2->WHPCR = ((width + hbp) << 16) | (hbp + 1);
+    LTDC_Layer2->WVPCR = ((y + height + vbp) << 16) | (y + vbp + 1);
+    LTDC_Layer2->CFBAR = LCD_FRAME_BUFFER + BUFFER_OFFSET + y * width;
+    LTDC_Layer2->CFBLR = (width << 16) | (width + 3); // One byte per pixel
+    LTDC_Layer2->CFBLNR = height;
+    LTDC->SRCR = LTDC_SRCR_VBR; // Apply at the next vertical blank
+
+    dynamicY = y;
+    dynamicHeight = height;
+}
+
+// Switch to a screen; returns true when its labels must be drawn on the static layer
+bool EnterScreen(int screen, uint16_t y, uint16_t height) {
+    if (currentScreen == screen) return false;
+
+    LCD.SelectLayer(LAYER_STATIC);
+    LCD.Clear(LCD_COLOR_WHITE);
+    SetDynamicWindow(y, height);
+
+    // The window is only cleared here; frames then repaint changed glyphs
+    L8Fill(dynamicFrame, 0, y, dynamicFrame.width, height, PALETTE_KEY);
+    for (int i = 0; i < DYNAMIC_LINES; i++) L8ResetLine(dynamicLines[i]);
+
+    currentScreen = screen;
+    return true;
+}
+
+// Draw a line of dynamic text onto layer 2, touching only the cells that changed
+void DynamicText(uint16_t y, const char* text, L8Align align) {
+    int slot = (y - dynamicY) / dynamicFont.height;
+    if (slot < 0 || slot >= DYNAMIC_LINES) return;
+
+    L8UpdateLine(dynamicFrame, dynamicFont, dynamicLines[slot], 0, y, text, align, PALETTE_TEXT, PALETTE_KEY);
 }
 
 // -----------------------------
 // Display Functions
 // -----------------------------
 
+// Board side of the LCD interface the screens in Screens.h draw through
+struct BoardLcd {
+    bool EnterScreen(int screen, uint16_t y, uint16_t height) { return ::EnterScreen(screen, y, height); }
+
+    void Label(uint16_t y, const char* text, L8Align align) {
+        LCD.DisplayStringAt(0, y, (uint8_t*)text, align == L8_ALIGN_CENTER ? CENTER_MODE : LEFT_MODE);
+    }
+
+    void DynamicText(uint16_t y, const char* text, L8Align align) { ::DynamicText(y, text, align); }
+
+    uint16_t Height() { return LCD.GetYSize(); }
+};
+
+BoardLcd boardLcd;
+
 // Show live current RTC time
 void ShowTime() {
-    LCD.Clear(LCD_COLOR_WHITE);
-    LCD.DisplayStringAt(0, 60, (uint8_t*)"Current Time", CENTER_MODE);
-
-    time(&rawTime);
-    struct tm* timeinfo = localtime(&rawTime);
-    char timebuff[20];
-    sprintf(timebuff, "%02d:%02d:%02d", timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
+    time_t now = time(NULL);
+    UpdateClockState([now](ClockState& s) { s.rawTime = now; });
+    ShowTime(boardLcd, now);
+}
 
-    LCD.DisplayStringAt(0, 100, (uint8_t*)timebuff, CENTER_MODE);
-    LCD.DisplayStringAt(0, 140, (uint8_t*)"(HH:MM:SS)", CENTER_MODE);
+// Show a window of logged button press times, newest first
+void ShowPreviousTimes(const ClockState& snapshot) {
+    PrefetchTrack(snapshot.historyOffset);
+    ShowPreviousTimes(boardLcd, storage, snapshot.historyOffset);
 }
 
-// Show last two logged button press times
-void ShowPreviousTimes() {
-    EEPROM::Read(EEPROM_ADDR, EEPROM_ADDR_1, prevTime1, 20);
-    EEPROM::Read(EEPROM_ADDR, EEPROM_ADDR_2, prevTime2, 20);
+// Show EEPROM write counters and projected endurance
+void ShowDiagnostics() {
+    ShowDiagnostics(boardLcd, TelemetryLine);
+}
 
-    LCD.Clear(LCD_COLOR_WHITE);
-    LCD.DisplayStringAt(0, 60, (uint8_t*)"Previous Times:", LEFT_MODE);
-    LCD.DisplayStringAt(0, 80, (uint8_t*)"(HH:MM:SS)", LEFT_MODE);
-    LCD.DisplayStringAt(0, 120, (uint8_t*)prevTime1, LEFT_MODE);
-    LCD.DisplayStringAt(0, 140, (uint8_t*)prevTime2, LEFT_MODE);
+// Show the running stopwatch and the newest lap split
+void ShowStopwatch(const ClockState& snapshot) {
+    uint64_t splitUs = lapsRecorded > 0 ? lapHistory[(lapsRecorded - 1) % LAP_HISTORY].splitUs : 0;
+    ShowStopwatch(boardLcd, StopwatchElapsed(snapshot, StopwatchNowUs()), snapshot.lapCount, lapsRecorded, splitUs);
 }
 
 // -----------------------------
 // EEPROM Storage Functions
 // -----------------------------
 
-// Save current RTC time into EEPROM (shift old log down)
+// Append current RTC time to the EEPROM log
 void SaveTime() {
-    // Get most recent saved time
-    EEPROM::Read(EEPROM_ADDR, EEPROM_ADDR_1, prevTime1, 20);
-
     // Fetch current RTC time
-    time(&rawTime);
-    struct tm* timeinfo = localtime(&rawTime);
-    char timebuff[20];
-    sprintf(timebuff, "%02d:%02d:%02d", timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
+    time_t now = time(NULL);
+
+    LogRecord record = {};
+    record.epoch = (uint32_t)now;
+    record.tag = LOG_CHANNEL_USER;
+    storage.LogAppend(record);
 
-    // Shift logs: [latest → addr1], [addr1 → addr2]
-    EEPROM::Write(EEPROM_ADDR, EEPROM_ADDR_2, prevTime1, 20);
-    EEPROM::Write(EEPROM_ADDR, EEPROM_ADDR_1, timebuff, 20);
+    char timebuff[20];
+    FormatRecordTime(record, timebuff);
 
     printf("Saved time to EEPROM: %s\n", timebuff);
 
-    state = DISPLAY_TIME; // Return to idle
+    CriticalSectionLock lock;
+    clockState.Write([now](ClockState& s) { s.rawTime = now; });
+    Dispatch(EV_SAVE_DONE); // Return to idle unless a button moved on
 }
 
 // -----------------------------
-// RTC Time-Set Mode
+// USB Log Export
 // -----------------------------
 
-// Display editable RTC time (with field highlighting)
-void SetTime() {
-    struct tm* timeInfo = localtime(&selectedTime);
-    char timebuff[20];
+// Stream the whole log to the USB host in full-speed bulk packets
+void ExportLog() {
+    LogStream<EepromBackend> stream(eepromBackend, storage.logHead, storage.logCount, storage.logGeneration);
+    char packet[64]; // Full-speed bulk max packet size
+    int n;
 
-    if (selectedField == 0) sprintf(timebuff, "|%02d|:%02d:%02d", timeInfo->tm_hour, timeInfo->tm_min, timeInfo->tm_sec);
-    else if (selectedField == 1) sprintf(timebuff, "%02d:|%02d|:%02d", timeInfo->tm_hour, timeInfo->tm_min, timeInfo->tm_sec);
-    else                         sprintf(timebuff, "%02d:%02d:|%02d|", timeInfo->tm_hour, timeInfo->tm_min, timeInfo->tm_sec);
+    while ((n = stream.Read(packet, sizeof(packet))) > 0) {
+        if (!usbSerial.send((uint8_t*)packet, n)) break; // Host went away
+    }
+}
 
-    LCD.Clear(LCD_COLOR_WHITE);
-    LCD.DisplayStringAt(0, 60, (uint8_t*)"Set Time", CENTER_MODE);
-    LCD.DisplayStringAt(0, 100, (uint8_t*)timebuff, CENTER_MODE);
-    LCD.DisplayStringAt(0, 140, (uint8_t*)"(HH:MM:SS)", CENTER_MODE);
+// Send the raw EEPROM contents; tools/log2col decodes these images
+void DumpImage() {
+    char block[64];
+
+    for (int addr = 0; addr < EEPROM_SIZE; addr += sizeof(block)) {
+        EEPROM::Read(EEPROM_ADDR, addr, block, sizeof(block));
+        if (!usbSerial.send((uint8_t*)block, sizeof(block))) break;
+    }
+}
+
+// Print one line per day for the last 31 days with a mark for each active hour
+void PrintMonthOverview() {
+    uint32_t today = (uint32_t)time(NULL) / 86400;
+
+    usbSerial.printf("date       000000000011111111112222\r\n");
+    usbSerial.printf("           012345678901234567890123\r\n");
+    for (uint32_t day = today - 30; day <= today; day++) {
+        uint32_t hours = storage.IndexHours(day);
+        time_t when = (time_t)day * 86400;
+        struct tm* date = localtime(&when);
+        char bar[25];
+
+        for (int h = 0; h < 24; h++) bar[h] = (hours & (1UL << h)) ? '#' : '.';
+        bar[24] = '\0';
+        usbSerial.printf("%04d-%02d-%02d %s\r\n", date->tm_year + 1900, date->tm_mon + 1, date->tm_mday, bar);
+    }
+}
+
+// Line commands ('a', 'x') take their argument from the rest of the line.
+// Bytes are collected across PollUsb() calls as they arrive, so a host that
+// sends the line slowly (or never finishes it) does not stall the UI loop.
+char usbCommand = 0;              // Line command waiting for its argument, 0 = none
+char usbLine[32];
+int usbLineLength = 0;
+
+// Take whatever has arrived of the pending line; true once it is complete
+bool ReadUsbLine() {
+    while (usbSerial.available()) {
+        int c = usbSerial.getc();
+        if (c == '\r' || c == '\n') {
+            usbLine[usbLineLength] = '\0';
+            usbLineLength = 0;
+            return true;
+        }
+        if (usbLineLength < (int)sizeof(usbLine) - 1) usbLine[usbLineLength++] = (char)c;
+    }
+    return false;
+}
+
+// "aHH:MM:SS[,minutes]": alarm at the next occurrence of that time of day,
+// repeating every given number of minutes (1440 for daily) if one is given
+void AddAlarmCommand(const char* line) {
+    int hours, minutes, seconds;
+    unsigned period = 0;
+
+    if (sscanf(line, "%d:%d:%d,%u", &hours, &minutes, &seconds, &period) < 3 ||
+        hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59 || period > 0xFFFF) {
+        usbSerial.printf("Usage: aHH:MM:SS[,minutes]\r\n");
+        return;
+    }
+
+    uint32_t now = (uint32_t)time(NULL);
+    uint32_t anchor = now - now % 86400 + hours * 3600 + minutes * 60 + seconds;
+    if (anchor <= now) anchor += 86400;
+
+    int slot = AlarmAdd(anchor, (uint16_t)period);
+    if (slot < 0) usbSerial.printf("Alarm table full\r\n");
+    else          usbSerial.printf("Alarm %d set\r\n", slot);
+}
+
+// "x<slot>": delete an alarm
+void DeleteAlarmCommand(const char* line) {
+    int slot = atoi(line);
+    if (slot < 0 || slot >= ALARM_SLOTS || !AlarmIsValid(alarms[slot])) {
+        usbSerial.printf("No alarm %s\r\n", line);
+        return;
+    }
+    AlarmDelete(slot);
+    AlarmService(); // Re-arm in case it was the earliest
+}
+
+// One line per active alarm: slot, next deadline, repeat period
+void ListAlarms() {
+    for (int i = 0; i < ALARM_SLOTS; i++) {
+        if (!AlarmIsValid(alarms[i])) continue;
+
+        time_t when = alarmDue[i];
+        struct tm* t = localtime(&when);
+        usbSerial.printf("%3d %04d-%02d-%02d %02d:%02d:%02d every %u min\r\n", i,
+                         t->tm_year + 1900, t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec,
+                         alarms[i].period);
+    }
+}
+
+// Lap splits of the current run, newest LAP_HISTORY laps, in microseconds
+void PrintLaps() {
+    int first = lapsRecorded > LAP_HISTORY ? lapsRecorded - LAP_HISTORY + 1 : 1;
+
+    usbSerial.printf("lap,elapsed_us,split_us\r\n");
+    for (int lap = first; lap <= lapsRecorded; lap++) {
+        const LapEvent& event = lapHistory[(lap - 1) % LAP_HISTORY];
+        usbSerial.printf("%d,%llu,%llu\r\n", lap, (unsigned long long)event.elapsedUs,
+                         (unsigned long long)event.splitUs);
+    }
+    if (lapsDropped) usbSerial.printf("dropped,%lu\r\n", (unsigned long)lapsDropped);
+}
+
+// Handle single-character commands from the USB host
+void PollUsb() {
+    if (!usbSerial.connected()) {
+        usbCommand = 0; // Drop a half-received line from the last session
+        usbLineLength = 0;
+        return;
+    }
+
+    while (usbSerial.available()) {
+        if (usbCommand) {
+            if (!ReadUsbLine()) return; // Rest of the line arrives on a later frame
+            if (usbCommand == 'a') AddAlarmCommand(usbLine);
+            else                   DeleteAlarmCommand(usbLine);
+            usbCommand = 0;
+            continue;
+        }
+
+        int command = usbSerial.getc();
+        switch (command) {
+            case 'd': GovernorBoost(); ExportLog(); break; // Dump log as CSV
+            case 'b': GovernorBoost(); DumpImage(); break; // Dump raw EEPROM image for host tools
+            case 'c': storage.LogClear(); break;  // Clear the log (generation bump)
+            case 'm': PrintMonthOverview(); break; // Hours with activity, last 31 days
+            case 'a':                     // Register an alarm
+            case 'x':                     // Delete an alarm
+                usbCommand = (char)command;
+                usbLineLength = 0;
+                break;
+            case 'l': ListAlarms(); break;         // List alarms
+            case 'p': PrintLaps(); break;          // Stopwatch lap splits
+            case 's': {                   // Print wear statistics
+                char linebuff[32];
+                for (int line = 0; TelemetryLine(line, linebuff); line++) {
+                    usbSerial.printf("%s\r\n", linebuff);
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+// -----------------------------
+// RTC Time-Set Mode
+// -----------------------------
+
+// Display editable RTC time (with field highlighting)
+void SetTime(const ClockState& snapshot) {
+    SetTime(boardLcd, snapshot.selectedTime, snapshot.selectedField);
 }
 
 // -----------------------------
 // Main Program
 // -----------------------------
 int main() {
+    mbed_mpu_manager_lock_ram_execution(); // RAM_FUNC code runs from SRAM; never released
+    i2c.frequency(I2C_FREQUENCY);
+
     // Attach interrupts
+    usbSerial.connect();
     userButton.fall(&GetTime);
     displayButton.attach(&DisplayTimes, IRQ_FALL, 100, false);
     cycleButton.attach(&ValueCycle, IRQ_FALL, 100, false);
     incrementButton.attach(&ValueIncrement, IRQ_FALL, 100, false);
 
     __enable_irq();
+    CycleCounterInit();
+
+    HwCrcInit();
+    CacheInit();
+    storage.TelemetryLoad();
+    storage.LogInit(); // Locate the ring head left by the previous session
+    storage.IndexLoad();
+    BenchmarkRecordCrc();
 
     // Initialize RTC to Jan 1, 2025, 00:00:00
     tm t = {0};
     t.tm_year = 125; // Years since 1900 → 2025
     set_time(mktime(&t));
+    AlarmInit(); // Needs the RTC running
+    AnchorRequest(); // Needs the alarm interrupt routed
 
     // LCD configuration
+    CompositorInit();
     LCD.SetFont(&Font20);
     LCD.SetTextColor(LCD_COLOR_BLACK);
 
     // FSM Loop
     while (1) {
+        // Consistent view of the ISR-owned state for this frame
+        ClockState snapshot = clockState.Read();
+        GovernorUpdate(snapshot.state);
+        uint32_t frameStart = DWT->CYCCNT;
+
         // If user updated RTC, apply changes
-        if (timeIsDirty) {
-            set_time(selectedTime);
-            timeIsDirty = false;
+        if (snapshot.timeIsDirty) {
+            set_time(snapshot.selectedTime);
+            AlarmReschedule(); // Deadlines are placed relative to the old time
+            AnchorRequest(); // The second edges moved with the clock
+            UpdateClockState([&snapshot](ClockState& s) {
+                if (s.selectedTime == snapshot.selectedTime) s.timeIsDirty = false; // Keep newer edits pending
+            });
         }
 
         // Execute state-specific behavior
-        switch (state) {
+        switch (snapshot.state) {
             case DISPLAY_TIME: ShowTime(); break;
             case SAVE_TIME:    SaveTime(); break;
-            case PREV_TIMES:   ShowPreviousTimes(); break;
-            case SET_TIME:     SetTime(); break;
+            case PREV_TIMES:   ShowPreviousTimes(snapshot); break;
+            case DIAGNOSTICS:  ShowDiagnostics(); break;
+            case SET_TIME:     SetTime(snapshot); break;
+            case STOPWATCH:    ShowStopwatch(snapshot); break;
+            default:           break;
         }
+        if (snapshot.state != SAVE_TIME) frameCycles.Add(DWT->CYCCNT - frameStart);
+
+        AnchorUpdate(snapshot);
+        LapDrain(); // Log laps captured since the last frame
+        PollUsb(); // Service log download requests
+
+        if (alarmPending) AlarmService(); // RTC alarm fired, or its deadline passed while it was being programmed
+
+        if (snapshot.state == PREV_TIMES) PrefetchIdle(); // Warm the cache ahead of the next scroll
 
         thread_sleep_for(100); // Refresh interval
     }
@@ -0,0 +1,96 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+// Shared-memory ring of composed L8 frames, published by a simulator and
+// watched by fbview. The ring is an ImageMap file, normally under /dev/shm:
+// the publisher composes straight into the next slot and the viewer renders
+// straight from it, so frames are never copied or serialized. Each slot is
+// a seqlock: its sequence reads 0 while being written, and a reader checks
+// it before and after using the pixels to catch a frame overwritten under it.
+
+#include "ImageMap.h"
+
+#include <atomic>
+#include <cstdint>
+
+#define FRAME_RING_MAGIC 0x474E5246 // "FRNG"
+#define FRAME_RING_SLOTS 8
+#define FRAME_RING_ALIGN 64
+
+struct FrameRingHeader {
+    uint32_t magic;                 // Written last, once the geometry is valid
+    uint16_t width;
+    uint16_t height;
+    uint32_t slots;
+    uint32_t slotBytes;             // Slot header plus pixels, padded
+    std::atomic<uint64_t> newest;   // Sequence of the newest complete frame, 0 = none yet
+};
+
+struct FrameSlot {
+    std::atomic<uint64_t> sequence; // Frame in this slot, 0 while it is being written
+    uint64_t virtualUs;             // Simulated time the frame was composed at
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "frame ring needs lock-free 64-bit atomics");
+
+inline uint32_t FrameRingSlotBytes(uint16_t width, uint16_t height) {
+    uint32_t bytes = FRAME_RING_ALIGN + width * height;
+    return (bytes + FRAME_RING_ALIGN - 1) / FRAME_RING_ALIGN * FRAME_RING_ALIGN;
+}
+
+inline FrameSlot* FrameRingSlot(uint8_t* base, const FrameRingHeader* header, uint64_t sequence) {
+    return (FrameSlot*)(base + FRAME_RING_ALIGN + (sequence % header->slots) * header->slotBytes);
+}
+
+inline uint8_t* FrameRingPixels(FrameSlot* slot) {
+    return (uint8_t*)slot + FRAME_RING_ALIGN;
+}
+
+// -----------------------------
+// Publisher
+// -----------------------------
+
+class FramePublisher {
+public:
+    bool Open(const char* path, uint16_t width, uint16_t height) {
+        uint32_t slotBytes = FrameRingSlotBytes(width, height);
+        if (!map.Open(path, IMAGE_SHARED, FRAME_RING_ALIGN + (size_t)FRAME_RING_SLOTS * slotBytes)) return false;
+
+        header = (FrameRingHeader*)map.data;
+        header->magic = 0;
+        header->width = width;
+        header->height = height;
+        header->slots = FRAME_RING_SLOTS;
+        header->slotBytes = slotBytes;
+        header->newest.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < FRAME_RING_SLOTS; i++) {
+            FrameRingSlot(map.data, header, i)->sequence.store(0, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = FRAME_RING_MAGIC;
+        return true;
+    }
+
+    // Claim the next slot; compose into the returned pixels, then Commit()
+    uint8_t* Begin() {
+        slot = FrameRingSlot(map.data, header, next);
+        slot->sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return FrameRingPixels(slot);
+    }
+
+    void Commit(uint64_t virtualUs) {
+        slot->virtualUs = virtualUs;
+        slot->sequence.store(next, std::memory_order_release);
+        header->newest.store(next, std::memory_order_release);
+        next++;
+    }
+
+private:
+    ImageMap map;
+    FrameRingHeader* header = nullptr;
+    FrameSlot* slot = nullptr;
+    uint64_t next = 1;
+};
+
+#endif
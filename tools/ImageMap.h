@@ -0,0 +1,126 @@
+#ifndef IMAGE_MAP_H
+#define IMAGE_MAP_H
+
+// Memory-mapped EEPROM images for the host tools. Images are raw dumps in
+// the layout USB command 'b' sends, so the simulator, log2col and ad-hoc
+// analysis all work on the same bytes in place: opening an image of any size
+// is one mmap() call, pages load on first touch, and writes through a shared
+// mapping land in the file with no explicit save. POSIX (Linux) only.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+enum ImageMode {
+    IMAGE_READ,    // Read-only view of an existing file
+    IMAGE_SHARED,  // Read-write; writes persist to the file
+    IMAGE_PRIVATE, // Read-write copy-on-write; the file is never modified
+};
+
+class ImageMap {
+public:
+    uint8_t* data = nullptr;
+    size_t size = 0;
+
+    ImageMap() {}
+    ~ImageMap() { Close(); }
+    ImageMap(const ImageMap&) = delete;
+    ImageMap& operator=(const ImageMap&) = delete;
+
+    // Map a file. IMAGE_SHARED creates the file if needed and grows it to
+    // size with erased (0xFF) bytes; size 0 maps the file as it is. The other
+    // modes need an existing file of at least size bytes.
+    bool Open(const char* path, ImageMode mode, size_t size = 0) {
+        Close();
+        fd = open(path, mode == IMAGE_SHARED ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd < 0) {
+            perror(path);
+            return false;
+        }
+        struct stat st;
+        fstat(fd, &st);
+        size_t length = (size_t)st.st_size;
+        if (size == 0) size = length;
+
+        if (size > length && mode != IMAGE_SHARED) {
+            fprintf(stderr, "%s: %zu bytes, expected at least %zu\n", path, length, size);
+            Close();
+            return false;
+        }
+        if (size > length && ftruncate(fd, (off_t)size) != 0) {
+            perror(path);
+            Close();
+            return false;
+        }
+        if (!Map(mode, size)) {
+            perror(path);
+            Close();
+            return false;
+        }
+        if (size > length) memset(data + length, 0xFF, size - length);
+        return true;
+    }
+
+    // Unnamed erased image backed by memory, which can still be snapshotted
+    bool Anonymous(size_t size) {
+        Close();
+        fd = memfd_create("eeprom", 0);
+        if (fd < 0 || ftruncate(fd, (off_t)size) != 0 || !Map(IMAGE_SHARED, size)) {
+            perror("memfd");
+            Close();
+            return false;
+        }
+        memset(data, 0xFF, size);
+        return true;
+    }
+
+    // Copy-on-write view of the backing file: one mmap() however large the
+    // image, and only pages the snapshot writes get copied. It sees the file,
+    // not another private view's changes, and pages it has not written still
+    // track the file, so leave the base alone while snapshots are in use.
+    bool Snapshot(ImageMap& out) const {
+        out.Close();
+        out.fd = dup(fd);
+        if (out.fd < 0 || !out.Map(IMAGE_PRIVATE, size)) {
+            perror("snapshot");
+            out.Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Swap(ImageMap& other) {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(fd, other.fd);
+    }
+
+    void Close() {
+        if (data) munmap(data, size);
+        if (fd >= 0) close(fd);
+        data = nullptr;
+        size = 0;
+        fd = -1;
+    }
+
+private:
+    int fd = -1;
+
+    bool Map(ImageMode mode, size_t length) {
+        if (length == 0) return true; // Empty file: nothing to map
+        int prot = mode == IMAGE_READ ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* p = mmap(nullptr, length, prot, mode == IMAGE_PRIVATE ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        data = (uint8_t*)p;
+        size = length;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+// Host model of one board's storage path for the simulators in tools/: a
+// 24FC64F EEPROM with bus timing and wear-out, running the firmware's own
+// log, presence index and telemetry code from LogStorage.h.
+
+#include "../LogStorage.h"
+#include "ImageMap.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Bus and part timing (24FC64F on a 100 kHz bus)
+#define SIM_I2C_BYTE_US 90        // 9 clocks per byte
+#define SIM_WRITE_CYCLE_US 5000   // Internal write cycle (tWC max)
+#define SIM_ENDURANCE 1000000UL   // Rated write cycles per page
+#define SIM_CACHE_PAGES 8         // CACHE_PAGES: record pages the firmware keeps in RAM
+
+// How a read reaches the part. The firmware's driver tracks the part's
+// internal address counter and skips the address phase when a read carries
+// on from it; otherwise the address write and the read share one
+// transaction through a repeated START. The split path is the driver it
+// replaced, kept to measure the difference.
+enum SimReadPath {
+    SIM_READ_SPLIT,               // Address write, STOP, then a separate read transaction
+    SIM_READ_COMBINED,            // Address write and read joined by a repeated START
+    SIM_READ_TRACKED,             // As combined, with current-address reads when the counter is known
+};
+
+// -----------------------------
+// EEPROM Model
+// -----------------------------
+
+// Byte image with the part's page-write semantics. Each page gets its own
+// endurance limit drawn around the rating; writes to a page past its limit
+// flip one bit of the written data, the way a worn cell stops holding charge.
+// The image lives in memory by default, or in a mapped file (Open) that
+// log2col can decode directly; larger parts just take a bigger size and page.
+class SimEeprom {
+public:
+    ImageMap image;
+    uint32_t pageSize;
+    std::vector<uint32_t> pageWrites; // Write cycles per page
+    uint64_t busBytes = 0;            // Data bytes sent in write transactions
+    uint64_t transferBytes = 0;       // Every byte on the bus, addressing included
+    uint64_t transactions = 0;        // START ... STOP sequences, reads and writes
+    uint32_t writeCount = 0;
+    SimReadPath readPath = SIM_READ_TRACKED;
+    int64_t pointer = -1;             // Address counter as the driver knows it, -1 = unknown
+    uint32_t wornWrites = 0;          // Writes that landed on a worn page
+
+    explicit SimEeprom(uint32_t size = EEPROM_SIZE, uint32_t pageSize = EEPROM_PAGE_SIZE)
+        : pageSize(pageSize), pageWrites(size / pageSize, 0), limits(size / pageSize, 0) {
+        if (!image.Anonymous(size)) exit(1);
+    }
+
+    // Switch to an image file of the same size (IMAGE_SHARED persists writes)
+    bool Open(const char* path, ImageMode mode) {
+        uint32_t size = Size();
+        ImageMap file;
+        if (!file.Open(path, mode, size)) return false;
+        image.Swap(file);
+        return true;
+    }
+
+    // Start as a copy-on-write snapshot of base, wear state included, e.g. to
+    // fuzz from a known image without copying or touching it
+    bool SnapshotOf(const SimEeprom& base) {
+        if (!base.image.Snapshot(image)) return false;
+        pageSize = base.pageSize;
+        pageWrites = base.pageWrites;
+        limits = base.limits;
+        return true;
+    }
+
+    uint32_t Size() const { return (uint32_t)image.size; }
+    void Erase() { memset(image.data, 0xFF, image.size); }
+
+    // Per-page limits between 1x and 4x the rating
+    void SetEndurance(uint32_t rated, std::mt19937_64& rng) {
+        std::uniform_real_distribution<double> spread(1.0, 4.0);
+        for (uint32_t& limit : limits) limit = (uint32_t)(rated * spread(rng));
+    }
+
+    // One write transaction. Data wraps within the page like the real part;
+    // keep < size models power failing mid-cycle (only a prefix is programmed).
+    // Returns the bus plus write-cycle time in microseconds.
+    uint32_t Write(uint32_t address, const void* data, uint32_t size, std::mt19937_64& rng, uint32_t keep = ~0u) {
+        uint8_t* mem = image.data;
+        uint32_t page = (address % Size()) / pageSize;
+        uint32_t pageBase = page * pageSize;
+        const uint8_t* bytes = (const uint8_t*)data;
+
+        for (uint32_t i = 0; i < size && i < keep; i++) {
+            mem[pageBase + (address + i) % pageSize] = bytes[i];
+        }
+        if (++pageWrites[page] > limits[page] && limits[page] != 0) {
+            uint32_t bit = rng() % (size * 8);
+            mem[pageBase + (address + bit / 8) % pageSize] ^= (uint8_t)(1 << (bit % 8));
+            wornWrites++;
+        }
+        busBytes += size;
+        transferBytes += 3 + size;
+        transactions++;
+        writeCount++;
+        pointer = pageBase + (address + size) % pageSize; // The counter rolls over within the page
+        return (3 + size) * SIM_I2C_BYTE_US + SIM_WRITE_CYCLE_US;
+    }
+
+    // Sequential read; returns the bus time in microseconds
+    uint32_t Read(uint32_t address, void* out, uint32_t size) {
+        address %= Size();
+        uint8_t* bytes = (uint8_t*)out;
+        for (uint32_t i = 0; i < size; i++) bytes[i] = image.data[(address + i) % Size()];
+
+        uint32_t overhead = 4;        // Device address, two address bytes, device address again
+        if (readPath == SIM_READ_SPLIT) {
+            transactions += 2;
+        } else {
+            transactions++;
+            if (readPath == SIM_READ_TRACKED && pointer == address) overhead = 1; // Current-address read
+        }
+        transferBytes += overhead + size;
+        pointer = (address + size) % Size();
+        return (overhead + size) * SIM_I2C_BYTE_US;
+    }
+
+    uint32_t MaxPageWrites() const {
+        uint32_t most = 0;
+        for (uint32_t w : pageWrites) most = w > most ? w : most;
+        return most;
+    }
+
+private:
+    std::vector<uint32_t> limits; // 0 = never wears out
+};
+
+// -----------------------------
+// Storage Engine
+// -----------------------------
+
+// Backend that runs the firmware's storage engine (LogStorage.h) on the
+// EEPROM model. It does what EEPROM::Write does on the board (the telemetry
+// count) and tracks the bus and write-cycle time spent, so a power failure
+// armed at a point in that time interrupts whichever write it lands in: cut
+// during the transfer the part never starts programming, cut during the write
+// cycle only a prefix of the data is programmed, and nothing issued after the
+// cut reaches the part. Cached reads go through the same LRU page cache as
+// on the board (EEPROM Page Cache in the firmware) unless it is turned off.
+class SimBackend {
+public:
+    SimEeprom& eeprom;
+    std::mt19937_64& rng;
+    Telemetry telemetry = {};
+    uint64_t busyUs = 0;          // Bus and write-cycle time since power-on
+    uint64_t powerFailUs = UINT64_MAX; // busyUs at which power fails
+    uint32_t uptimeSeconds = 0;   // Reported to telemetry checkpoints
+    uint32_t tornWrites = 0;      // Writes cut during their write cycle
+    uint32_t lostWrites = 0;      // Writes cut during the transfer, or issued after the cut
+    bool pageCache = true;
+
+    SimBackend(SimEeprom& eeprom, std::mt19937_64& rng) : eeprom(eeprom), rng(rng) { Reset(); }
+
+    void Write(unsigned eeaddress, const void* data, int size) {
+        telemetry.CountWrite(eeaddress, size);
+        uint64_t transferEnd = busyUs + (3 + size) * SIM_I2C_BYTE_US;
+        if (powerFailUs < transferEnd) {
+            if (busyUs < powerFailUs) busyUs = powerFailUs;
+            lostWrites++;
+            return;
+        }
+
+        uint32_t keep = ~0u;
+        if (powerFailUs < transferEnd + SIM_WRITE_CYCLE_US) {
+            keep = rng() % size;
+            tornWrites++;
+        }
+        busyUs += eeprom.Write(eeaddress, data, size, rng, keep);
+        CachedPage* entry = CacheLookup(eeaddress / EEPROM_PAGE_SIZE);
+        if (entry) memcpy(&entry->data[eeaddress % EEPROM_PAGE_SIZE], data, size);
+    }
+
+    void Read(unsigned eeaddress, void* data, int size) {
+        busyUs += eeprom.Read(eeaddress, data, size);
+    }
+
+    // Bytes within one page, from the cache when it holds the page
+    void ReadCached(unsigned eeaddress, void* data, int size) {
+        if (!pageCache) {
+            Read(eeaddress, data, size);
+            return;
+        }
+        int page = eeaddress / EEPROM_PAGE_SIZE;
+        CachedPage* entry = CacheLookup(page);
+        if (!entry) { // Load into the least recently used entry
+            entry = &cache[0];
+            for (CachedPage& candidate : cache) {
+                if (candidate.lastUse < entry->lastUse) entry = &candidate;
+            }
+            Read(page * EEPROM_PAGE_SIZE, entry->data, EEPROM_PAGE_SIZE);
+            entry->page = page;
+        }
+        entry->lastUse = ++cacheClock;
+        memcpy(data, &entry->data[eeaddress % EEPROM_PAGE_SIZE], size);
+    }
+
+    uint32_t UptimeSeconds() { return uptimeSeconds; }
+
+    // RAM lost at power-off: the cache, and the driver's idea of the address counter
+    void Reset() {
+        for (CachedPage& entry : cache) entry = CachedPage{-1, 0, {}};
+        cacheClock = 0;
+        eeprom.pointer = -1;
+    }
+
+private:
+    struct CachedPage {
+        int page;                 // -1 when unused
+        uint32_t lastUse;
+        uint8_t data[EEPROM_PAGE_SIZE];
+    };
+    CachedPage cache[SIM_CACHE_PAGES] = {};
+    uint32_t cacheClock = 0;
+
+    CachedPage* CacheLookup(int page) {
+        for (CachedPage& entry : cache) {
+            if (entry.page == page) return &entry;
+        }
+        return nullptr;
+    }
+};
+
+// The firmware's storage engine on one SimEeprom. RAM state is lost on a
+// power cycle and rebuilt by PowerOn() from the EEPROM contents; the calls
+// that touch the part return the bus and write-cycle time they took.
+class SimStorage {
+public:
+    SimBackend backend;
+    LogStorage<SimBackend> log;
+
+    SimStorage(SimEeprom& eeprom, std::mt19937_64& rng) : backend(eeprom, rng), log(backend, backend.telemetry) {}
+
+    // Boot-time reads, in the order main() does them
+    uint32_t PowerOn() {
+        backend.telemetry = Telemetry();
+        backend.Reset();
+        backend.powerFailUs = UINT64_MAX;
+        uint64_t start = backend.busyUs;
+        log.TelemetryLoad();
+        log.LogInit();
+        log.IndexLoad();
+        return (uint32_t)(backend.busyUs - start);
+    }
+
+    // Power fails this far into the next storage operation (UINT64_MAX = never)
+    void PowerFailIn(uint64_t us) {
+        backend.powerFailUs = us == UINT64_MAX ? UINT64_MAX : backend.busyUs + us;
+    }
+
+    // Append one record with its index update and periodic checkpoint
+    uint32_t LogAppend(const LogRecord& record) {
+        uint64_t start = backend.busyUs;
+        log.LogAppend(record);
+        return (uint32_t)(backend.busyUs - start);
+    }
+
+    uint32_t LogClear() {
+        uint64_t start = backend.busyUs;
+        log.LogClear();
+        return (uint32_t)(backend.busyUs - start);
+    }
+
+    bool LogReadNewest(int age, LogRecord* record) { return log.LogReadNewest(age, record); }
+};
+
+#endif
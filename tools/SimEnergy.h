@@ -0,0 +1,114 @@
+#ifndef SIM_ENERGY_H
+#define SIM_ENERGY_H
+
+// Battery estimate for the simulators in tools/. Charge is accumulated from
+// per-state currents (split into time the MCU is running and time it sleeps
+// in thread_sleep_for) plus fixed costs per I2C byte, EEPROM write cycle and
+// LCD refresh. The defaults are rough figures for the DISCO_F429ZI at 3.3 V;
+// override them with measured ones (-P name=value in fleetsim).
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+enum SimState { SIM_BOOT, SIM_IDLE, SIM_SAVE, SIM_STATES }; // Powered states; off draws nothing
+
+static const char* const simStateNames[SIM_STATES] = {"boot", "idle", "save"};
+
+// -----------------------------
+// Model Parameters
+// -----------------------------
+
+struct EnergyModel {
+    double activeMa[SIM_STATES] = {110, 100, 100}; // MCU running: 180 MHz core, SDRAM, LTDC
+    double sleepMa[SIM_STATES] = {110, 45, 45};    // MCU in sleep mode between frames/write cycles
+    double lcdMa = 60;          // Panel and backlight whenever powered
+    double frameActiveUs = 4000; // CPU time per idle frame (FSM, RTC read, dynamic layer update)
+    double refreshUc = 25;      // Per frame the display is redrawn
+    double i2cByteUc = 0.03;    // Per byte on the bus (pull-ups, EEPROM interface)
+    double writeCycleUc = 15;   // Per EEPROM internal write cycle (3 mA for 5 ms)
+
+    // Apply one "name=value" override; false for an unknown name
+    bool Set(const char* assignment) {
+        const char* eq = strchr(assignment, '=');
+        if (!eq) return false;
+        std::string name(assignment, eq - assignment);
+
+        for (int s = 0; s < SIM_STATES; s++) {
+            if (name == std::string(simStateNames[s]) + "_active_ma") return Assign(&activeMa[s], eq + 1);
+            if (name == std::string(simStateNames[s]) + "_sleep_ma") return Assign(&sleepMa[s], eq + 1);
+        }
+        const struct {
+            const char* name;
+            double* value;
+        } fields[] = {
+            {"lcd_ma", &lcdMa},
+            {"frame_active_us", &frameActiveUs},
+            {"refresh_uc", &refreshUc},
+            {"i2c_byte_uc", &i2cByteUc},
+            {"write_cycle_uc", &writeCycleUc},
+        };
+        for (const auto& field : fields) {
+            if (name == field.name) return Assign(field.value, eq + 1);
+        }
+        return false;
+    }
+
+    static const char* Names() {
+        return "<boot|idle|save>_active_ma, <boot|idle|save>_sleep_ma, lcd_ma, frame_active_us, "
+               "refresh_uc, i2c_byte_uc, write_cycle_uc";
+    }
+
+private:
+    static bool Assign(double* field, const char* text) {
+        char* end;
+        double value = strtod(text, &end);
+        if (end == text || *end != '\0' || value < 0) return false;
+        *field = value;
+        return true;
+    }
+};
+
+// -----------------------------
+// Charge Meter
+// -----------------------------
+
+// Charge in microcoulombs (mA x us / 1000) by where it went
+struct EnergyMeter {
+    double stateUc[SIM_STATES] = {};
+    double lcdUc = 0;
+    double refreshUc = 0;
+    double i2cUc = 0;
+    double eepromUc = 0;
+
+    // Time spent powered in one state, split into running and sleeping
+    void Span(const EnergyModel& model, SimState state, double activeUs, double sleepUs) {
+        stateUc[state] += (model.activeMa[state] * activeUs + model.sleepMa[state] * sleepUs) / 1000;
+        lcdUc += model.lcdMa * (activeUs + sleepUs) / 1000;
+    }
+
+    void Refreshes(const EnergyModel& model, double frames) { refreshUc += model.refreshUc * frames; }
+
+    void Eeprom(const EnergyModel& model, double busBytes, double writeCycles) {
+        i2cUc += model.i2cByteUc * busBytes;
+        eepromUc += model.writeCycleUc * writeCycles;
+    }
+
+    void Merge(const EnergyMeter& other) {
+        for (int s = 0; s < SIM_STATES; s++) stateUc[s] += other.stateUc[s];
+        lcdUc += other.lcdUc;
+        refreshUc += other.refreshUc;
+        i2cUc += other.i2cUc;
+        eepromUc += other.eepromUc;
+    }
+
+    double TotalUc() const {
+        double total = lcdUc + refreshUc + i2cUc + eepromUc;
+        for (double uc : stateUc) total += uc;
+        return total;
+    }
+
+    static double ToMah(double uc) { return uc / 3.6e6; } // 1 mAh = 3.6 C
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+// Discrete-event virtual time for the simulators in tools/. Pending events
+// sit in a priority queue ordered by due time; running one jumps the clock
+// straight to it, so simulated idle time costs nothing and a run depends
+// only on its inputs. Host stand-ins for the Mbed time APIs the firmware
+// uses (thread_sleep_for, Timeout, the RTC) are built on top.
+//
+// One kernel per simulated board. Kernels are not thread safe, but separate
+// kernels can run on separate threads.
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// -----------------------------
+// Event Kernel
+// -----------------------------
+
+class SimKernel {
+public:
+    typedef std::function<void()> Callback;
+    typedef uint64_t EventId; // 0 = no event
+
+    SimKernel() { Bind(); }
+    ~SimKernel() {
+        if (current == this) current = nullptr;
+    }
+
+    // Make this the kernel behind thread_sleep_for() on the calling thread
+    void Bind() { current = this; }
+    static SimKernel* Current() { return current; }
+
+    uint64_t Now() const { return now; } // Virtual microseconds since the kernel started
+
+    // Schedule fn at an absolute time (clamped to now). Events due at the same
+    // time run in the order they were scheduled.
+    EventId At(uint64_t when, Callback fn) {
+        uint32_t slot;
+        if (freeSlots.empty()) {
+            slot = (uint32_t)slots.size();
+            slots.push_back(Slot{nullptr, 1});
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        slots[slot].fn = std::move(fn);
+        EventId id = ((uint64_t)slots[slot].generation << 32) | slot;
+        queue.push(Pending{when < now ? now : when, ++lastSequence, id});
+        return id;
+    }
+
+    EventId After(uint64_t delay, Callback fn) { return At(now + delay, std::move(fn)); }
+
+    // Drop a pending event; false if it already ran or was cancelled.
+    // Cancelled entries stay queued and are skipped when they come up.
+    bool Cancel(EventId id) {
+        if (!IsPending(id)) return false;
+        Release((uint32_t)id);
+        return true;
+    }
+
+    bool IsPending(EventId id) const {
+        uint32_t slot = (uint32_t)id;
+        return slot < slots.size() && slots[slot].generation == (uint32_t)(id >> 32);
+    }
+
+    // Due time of the earliest pending event, UINT64_MAX if there is none
+    uint64_t NextEvent() {
+        SkipCancelled();
+        return queue.empty() ? UINT64_MAX : queue.top().when;
+    }
+
+    // Run every event due up to and including end, then leave the clock at end
+    void RunUntil(uint64_t end) {
+        while (NextEvent() <= end) {
+            Pending next = queue.top();
+            queue.pop();
+            Callback fn = std::move(slots[(uint32_t)next.id].fn);
+            Release((uint32_t)next.id);
+            now = next.when;
+            fn();
+        }
+        if (end > now) now = end;
+    }
+
+    // Block the caller for a while. Events falling inside the interval run
+    // first, the way interrupts and other threads still run while the main
+    // thread sleeps or waits on the bus.
+    void Sleep(uint64_t us) { RunUntil(now + us); }
+
+    size_t PendingCount() const { return slots.size() - freeSlots.size(); }
+
+private:
+    struct Pending {
+        uint64_t when;
+        uint64_t sequence; // Tie-break between events due at the same time
+        EventId id;
+
+        bool operator>(const Pending& other) const {
+            return when != other.when ? when > other.when : sequence > other.sequence;
+        }
+    };
+
+    // Callbacks live in reusable slots; an EventId is the slot's generation
+    // in the high word and its index in the low word, so ids of events that
+    // ran or were cancelled go stale instead of matching a newer event
+    struct Slot {
+        Callback fn;
+        uint32_t generation;
+    };
+
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> queue;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    uint64_t now = 0;
+    uint64_t lastSequence = 0;
+
+    static inline thread_local SimKernel* current = nullptr;
+
+    void Release(uint32_t slot) {
+        slots[slot].fn = nullptr;
+        slots[slot].generation++;
+        freeSlots.push_back(slot);
+    }
+
+    void SkipCancelled() {
+        while (!queue.empty() && !IsPending(queue.top().id)) queue.pop();
+    }
+};
+
+// -----------------------------
+// Mbed Time API Stand-Ins
+// -----------------------------
+
+// Same signature as the Mbed call, on the thread's bound kernel
+inline void thread_sleep_for(uint32_t ms) {
+    SimKernel::Current()->Sleep((uint64_t)ms * 1000);
+}
+
+// One-shot callback, like mbed::Timeout. Re-attaching replaces the pending one.
+class SimTimeout {
+public:
+    explicit SimTimeout(SimKernel& kernel) : kernel(kernel) {}
+    ~SimTimeout() { detach(); }
+
+    void attach_us(SimKernel::Callback fn, uint64_t us) {
+        detach();
+        event = kernel.After(us, [this, fn] {
+            event = 0;
+            fn();
+        });
+    }
+
+    void detach() {
+        if (event) kernel.Cancel(event);
+        event = 0;
+    }
+
+    bool pending() const { return event != 0; }
+
+private:
+    SimKernel& kernel;
+    SimKernel::EventId event = 0;
+};
+
+// RTC seconds counter: set_time() anchors it to the virtual clock
+class SimRtc {
+public:
+    explicit SimRtc(SimKernel& kernel, uint32_t epoch = 0) : kernel(kernel) { set_time(epoch); }
+
+    uint32_t time() const { return base + (uint32_t)((kernel.Now() - setAt) / 1000000); }
+
+    void set_time(uint32_t epoch) {
+        base = epoch;
+        setAt = kernel.Now();
+    }
+
+private:
+    SimKernel& kernel;
+    uint32_t base = 0;
+    uint64_t setAt = 0;
+};
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef SIM_LCD_H
+#define SIM_LCD_H
+
+// Host stand-in for the LCD and the firmware's two-layer compositor (see
+// "Screen Compositing" in the firmware). Both layers are kept as L8 frames:
+// the static layer only ever holds black labels on white, which the palette
+// already covers. Compose() does what the LTDC does on every scan-out, and
+// FrameHash() reduces the result to 64 bits so frames can be checked against
+// golden values at negligible cost. SimLcd is the host side of the LCD
+// interface the screens in Screens.h draw through.
+
+#include "../Framebuffer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define SIM_LCD_WIDTH  240
+#define SIM_LCD_HEIGHT 320
+#define SIM_LCD_LINES  16         // DYNAMIC_LINES
+
+// -----------------------------
+// Host Font
+// -----------------------------
+
+// The BSP fonts are not available on the host. These 5x9 glyphs (rows 7-8
+// are descenders, bit 4 is the leftmost column) are doubled into Font20's
+// 14x20 cell, so text lays out and clips exactly as on the device.
+static const uint8_t simGlyphs[95][9] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // space
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, // !
+    0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // "
+    0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00, 0x00, // #
+    0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04, 0x00, 0x00, // $
+    0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03, 0x00, 0x00, // %
+    0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D, 0x00, 0x00, // &
+    0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // quote
+    0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00, 0x00, // (
+    0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00, 0x00, // )
+    0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00, 0x00, 0x00, // *
+    0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00, 0x00, // +
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x04, 0x08, // ,
+    0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, // -
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00, 0x00, // .
+    0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00, 0x00, // /
+    0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E, 0x00, 0x00, // 0
+    0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00, // 1
+    0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F, 0x00, 0x00, // 2
+    0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E, 0x00, 0x00, // 3
+    0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02, 0x00, 0x00, // 4
+    0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E, 0x00, 0x00, // 5
+    0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E, 0x00, 0x00, // 6
+    0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08, 0x00, 0x00, // 7
+    0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00, 0x00, // 8
+    0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C, 0x00, 0x00, // 9
+    0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x00, // :
+    0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x04, 0x08, 0x00, // ;
+    0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00, // <
+    0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00, // =
+    0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00, 0x00, // >
+    0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04, 0x00, 0x00, // ?
+    0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E, 0x00, 0x00, // @
+    0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00, 0x00, // A
+    0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E, 0x00, 0x00, // B
+    0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E, 0x00, 0x00, // C
+    0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C, 0x00, 0x00, // D
+    0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F, 0x00, 0x00, // E
+    0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10, 0x00, 0x00, // F
+    0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F, 0x00, 0x00, // G
+    0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00, 0x00, // H
+    0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00, // I
+    0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C, 0x00, 0x00, // J
+    0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11, 0x00, 0x00, // K
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F, 0x00, 0x00, // L
+    0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00, 0x00, // M
+    0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11, 0x00, 0x00, // N
+    0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00, // O
+    0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10, 0x00, 0x00, // P
+    0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D, 0x00, 0x00, // Q
+    0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11, 0x00, 0x00, // R
+    0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E, 0x00, 0x00, // S
+    0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, // T
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00, // U
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00, 0x00, // V
+    0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00, 0x00, // W
+    0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00, 0x00, // X
+    0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x00, 0x00, // Y
+    0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F, 0x00, 0x00, // Z
+    0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E, 0x00, 0x00, // [
+    0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, // backslash
+    0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E, 0x00, 0x00, // ]
+    0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // ^
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, // _
+    0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // `
+    0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F, 0x00, 0x00, // a
+    0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E, 0x00, 0x00, // b
+    0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E, 0x00, 0x00, // c
+    0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F, 0x00, 0x00, // d
+    0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00, 0x00, // e
+    0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08, 0x00, 0x00, // f
+    0x00, 0x00, 0x0F, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x0E, // g
+    0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00, 0x00, // h
+    0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00, // i
+    0x02, 0x00, 0x06, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C, // j
+    0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12, 0x00, 0x00, // k
+    0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00, 0x00, // l
+    0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11, 0x00, 0x00, // m
+    0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00, 0x00, // n
+    0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00, // o
+    0x00, 0x00, 0x1E, 0x11, 0x11, 0x11, 0x1E, 0x10, 0x10, // p
+    0x00, 0x00, 0x0F, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x01, // q
+    0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10, 0x00, 0x00, // r
+    0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E, 0x00, 0x00, // s
+    0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06, 0x00, 0x00, // t
+    0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D, 0x00, 0x00, // u
+    0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00, 0x00, // v
+    0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00, 0x00, // w
+    0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00, 0x00, // x
+    0x00, 0x00, 0x11, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x0E, // y
+    0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F, 0x00, 0x00, // z
+    0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00, 0x00, // {
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, // |
+    0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00, 0x00, // }
+    0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00, 0x00, // ~
+};
+
+#define SIM_FONT_WIDTH  14
+#define SIM_FONT_HEIGHT 20
+
+// Table in the BSP sFONT layout, built on first use
+inline L8Font SimFont20() {
+    static const std::vector<uint8_t> table = [] {
+        const int rowBytes = (SIM_FONT_WIDTH + 7) / 8;
+        std::vector<uint8_t> t(95 * SIM_FONT_HEIGHT * rowBytes, 0);
+        for (int c = 0; c < 95; c++) {
+            for (int row = 0; row < 9; row++) {
+                uint16_t bits = 0; // Doubled glyph row, two columns in from the left
+                for (int col = 0; col < 5; col++) {
+                    if (simGlyphs[c][row] & (0x10 >> col)) bits |= 0xC000 >> (2 + 2 * col);
+                }
+                for (int copy = 0; copy < 2; copy++) {
+                    uint8_t* dst = &t[(c * SIM_FONT_HEIGHT + 1 + 2 * row + copy) * rowBytes];
+                    dst[0] = (uint8_t)(bits >> 8);
+                    dst[1] = (uint8_t)bits;
+                }
+            }
+        }
+        return t;
+    }();
+    return L8Font{table.data(), SIM_FONT_WIDTH, SIM_FONT_HEIGHT};
+}
+
+// -----------------------------
+// Mock LCD
+// -----------------------------
+
+class SimLcd {
+public:
+    std::vector<uint8_t> staticPixels;  // Layer 1: labels, redrawn per screen
+    std::vector<uint8_t> dynamicPixels; // Layer 2: full-screen L8, scanned out in a window
+    std::vector<uint8_t> composed;      // What the panel shows after Compose()
+    L8Frame staticFrame;
+    L8Frame dynamicFrame;
+    L8Font font;
+    int currentScreen = -1;
+    uint16_t dynamicY = 0;
+    uint16_t dynamicHeight = 0;
+
+    SimLcd()
+        : staticPixels(SIM_LCD_WIDTH * SIM_LCD_HEIGHT, PALETTE_KEY),
+          dynamicPixels(SIM_LCD_WIDTH * SIM_LCD_HEIGHT, PALETTE_KEY),
+          composed(SIM_LCD_WIDTH * SIM_LCD_HEIGHT, PALETTE_KEY),
+          staticFrame{staticPixels.data(), SIM_LCD_WIDTH, SIM_LCD_HEIGHT},
+          dynamicFrame{dynamicPixels.data(), SIM_LCD_WIDTH, SIM_LCD_HEIGHT},
+          font(SimFont20()) {
+        for (L8TextLine& line : lines) L8ResetLine(line);
+    }
+
+    // Same contract as the firmware's EnterScreen: true when the caller
+    // must draw the new screen's labels
+    bool EnterScreen(int screen, uint16_t y, uint16_t height) {
+        if (currentScreen == screen) return false;
+
+        L8Fill(staticFrame, 0, 0, SIM_LCD_WIDTH, SIM_LCD_HEIGHT, PALETTE_KEY); // LCD.Clear(white)
+        dynamicY = y;
+        dynamicHeight = height;
+        L8Fill(dynamicFrame, 0, y, SIM_LCD_WIDTH, height, PALETTE_KEY);
+        for (L8TextLine& line : lines) L8ResetLine(line);
+
+        currentScreen = screen;
+        return true;
+    }
+
+    uint16_t Height() const { return SIM_LCD_HEIGHT; }
+
+    // LCD.DisplayStringAt on the static layer (LEFT_MODE or CENTER_MODE)
+    void Label(uint16_t y, const char* text, L8Align align) {
+        L8DrawString(staticFrame, font, 0, y, text, align, PALETTE_TEXT, PALETTE_KEY);
+    }
+
+    void DynamicText(uint16_t y, const char* text, L8Align align) {
+        int slot = (y - dynamicY) / font.height;
+        if (slot < 0 || slot >= SIM_LCD_LINES) return;
+        L8UpdateLine(dynamicFrame, font, lines[slot], 0, y, text, align, PALETTE_TEXT, PALETTE_KEY);
+    }
+
+    // Layer 2 over layer 1 inside the window, with PALETTE_KEY keyed out.
+    // out takes SIM_LCD_WIDTH * SIM_LCD_HEIGHT bytes, e.g. a frame ring slot.
+    void ComposeInto(uint8_t* out) const {
+        memcpy(out, staticPixels.data(), staticPixels.size());
+        for (int y = dynamicY; y < dynamicY + dynamicHeight && y < SIM_LCD_HEIGHT; y++) {
+            const uint8_t* src = &dynamicPixels[y * SIM_LCD_WIDTH];
+            uint8_t* dst = out + y * SIM_LCD_WIDTH;
+            for (int x = 0; x < SIM_LCD_WIDTH; x++) {
+                if (src[x] != PALETTE_KEY) dst[x] = src[x];
+            }
+        }
+    }
+
+    const std::vector<uint8_t>& Compose() {
+        ComposeInto(composed.data());
+        return composed;
+    }
+
+private:
+    L8TextLine lines[SIM_LCD_LINES];
+};
+
+// -----------------------------
+// Frame Hashing and Dumps
+// -----------------------------
+
+// 64-bit multiply-xorshift hash over 8-byte words (little-endian hosts);
+// a 240x320 L8 frame takes a few microseconds
+inline uint64_t FrameHash(const uint8_t* data, size_t size) {
+    const uint64_t m = 0xFF51AFD7ED558CCDULL;
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ (size * m);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * m;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++) h = (h ^ data[i]) * m;
+
+    h ^= h >> 33; // Final avalanche (MurmurHash3 fmix64)
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint32_t PngCrc(uint32_t crc, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return crc;
+}
+
+// Palette PNG of an L8 frame, using stored (uncompressed) deflate blocks so
+// no zlib is needed. Only written when a frame fails its check.
+inline bool WritePng(const char* path, const uint8_t* pixels, int width, int height) {
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        perror(path);
+        return false;
+    }
+
+    auto put32 = [](std::vector<uint8_t>& v, uint32_t x) {
+        for (int shift = 24; shift >= 0; shift -= 8) v.push_back((uint8_t)(x >> shift));
+    };
+    auto chunk = [&](const char* type, const std::vector<uint8_t>& body) {
+        std::vector<uint8_t> c;
+        put32(c, (uint32_t)body.size());
+        c.insert(c.end(), type, type + 4);
+        c.insert(c.end(), body.begin(), body.end());
+        put32(c, ~PngCrc(0xFFFFFFFF, &c[4], c.size() - 4));
+        fwrite(c.data(), 1, c.size(), out);
+    };
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), out);
+
+    std::vector<uint8_t> header;
+    put32(header, width);
+    put32(header, height);
+    header.insert(header.end(), {8, 3, 0, 0, 0}); // 8-bit palette indices
+    chunk("IHDR", header);
+
+    std::vector<uint8_t> palette;
+    for (uint32_t rgb : paletteRgb) palette.insert(palette.end(), {(uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb});
+    chunk("PLTE", palette);
+
+    std::vector<uint8_t> raw; // Filter byte 0, then the row
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels + y * width, pixels + (y + 1) * width);
+    }
+    std::vector<uint8_t> z = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t pos = 0; pos < raw.size(); pos += 65535) {
+        size_t n = raw.size() - pos < 65535 ? raw.size() - pos : 65535;
+        z.push_back(pos + n == raw.size() ? 1 : 0); // BFINAL, BTYPE 00
+        z.insert(z.end(), {(uint8_t)n, (uint8_t)(n >> 8), (uint8_t)~n, (uint8_t)(~n >> 8)});
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+    }
+    put32(z, (b << 16) | a);
+    chunk("IDAT", z);
+    chunk("IEND", {});
+    return fclose(out) == 0;
+}
+
+#endif
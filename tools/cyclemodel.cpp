@@ -0,0 +1,111 @@
+// Host tool: instruction-fetch cycle model for the code the firmware places in
+// SRAM with RAM_FUNC. It reads the symbol table of a firmware build and, for
+// every function linked into SRAM, estimates the fetch stalls the same code
+// would see from flash, which is the jitter RAM placement removes. Compare
+// it with the ISR and frame min/max the diagnostics screen measures.
+//
+// Build:   g++ -O2 -std=c++17 cyclemodel.cpp -o cyclemodel
+// Run:     arm-none-eabi-nm -S -C firmware.elf | cyclemodel [-w wait-states] [-a]
+//
+// Model: flash is read through the ART accelerator in 128-bit lines. A line
+// already in its 64-line instruction cache costs nothing extra; a miss stalls
+// the core for the flash wait states (5 at 180 MHz, 2 at the governor's
+// 90 MHz). A path of n lines therefore varies by up to n x wait states
+// between a warm and a cold cache, since any other code may have evicted it.
+// The prefetch buffer can hide some misses in straight-line code, so this is
+// an upper bound. SRAM has no wait states and no cache, so its fetch time is
+// the same on every run (the bound is 0). -a also lists functions left in
+// flash.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint32_t FLASH_BASE_ADDR = 0x08000000;
+static const uint32_t FLASH_END_ADDR = 0x08200000; // 2 MB
+static const uint32_t SRAM_BASE_ADDR = 0x20000000;
+static const uint32_t SRAM_END_ADDR = 0x20030000;  // SRAM1-3, 192 KB
+static const int ART_LINE_BYTES = 16;
+static const int ART_LINES = 64;
+
+struct Function {
+    uint32_t address;
+    uint32_t size;
+    std::string name;
+};
+
+// Lines of 128 bits the function body touches, given where it starts
+static uint32_t Lines(const Function& f) {
+    uint32_t first = f.address / ART_LINE_BYTES;
+    uint32_t last = (f.address + f.size - 1) / ART_LINE_BYTES;
+    return last - first + 1;
+}
+
+static void Usage() {
+    fprintf(stderr, "usage: arm-none-eabi-nm -S -C firmware.elf | cyclemodel [-w wait-states] [-a]\n");
+}
+
+int main(int argc, char** argv) {
+    int waitStates = 5;
+    bool all = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) waitStates = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0) all = true;
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (waitStates < 0) {
+        Usage();
+        return 2;
+    }
+
+    // nm -S lines: address size type name (symbols without a size are skipped)
+    std::vector<Function> ram, flash;
+    char line[1024];
+    while (fgets(line, sizeof(line), stdin)) {
+        unsigned long address, size;
+        char type;
+        int nameStart = 0;
+        if (sscanf(line, "%lx %lx %c %n", &address, &size, &type, &nameStart) < 3 || nameStart == 0) continue;
+        if (type != 't' && type != 'T' && type != 'w' && type != 'W') continue;
+        if (size == 0) continue;
+
+        Function f = {(uint32_t)(address & ~1UL), (uint32_t)size, std::string(line + nameStart)};
+        while (!f.name.empty() && (f.name.back() == '\n' || f.name.back() == '\r')) f.name.pop_back();
+
+        if (f.address >= SRAM_BASE_ADDR && f.address < SRAM_END_ADDR) ram.push_back(f);
+        else if (f.address >= FLASH_BASE_ADDR && f.address < FLASH_END_ADDR) flash.push_back(f);
+    }
+    if (ram.empty()) {
+        fprintf(stderr, "no functions linked into SRAM (GCC_ARM build with RAM_FUNC expected)\n");
+        return 1;
+    }
+
+    printf("%-40s %6s %6s %14s %10s\n", "function (SRAM)", "bytes", "lines", "flash jitter", "SRAM");
+    uint32_t totalBytes = 0, totalLines = 0;
+    for (const Function& f : ram) {
+        uint32_t lines = Lines(f);
+        totalBytes += f.size;
+        totalLines += lines;
+        printf("%-40.40s %6u %6u %11u cy %7u cy\n", f.name.c_str(), f.size, lines, lines * waitStates, 0u);
+    }
+    printf("%-40s %6u %6u %11u cy %7u cy\n", "total", totalBytes, totalLines, totalLines * waitStates, 0u);
+    if (totalLines > ART_LINES) {
+        printf("note: %u lines exceed the %d-line ART cache, so even back-to-back runs miss in flash\n",
+               totalLines, ART_LINES);
+    }
+
+    if (all) {
+        printf("\n%-40s %6s %6s %14s\n", "function (flash)", "bytes", "lines", "flash jitter");
+        for (const Function& f : flash) {
+            uint32_t lines = Lines(f);
+            printf("%-40.40s %6u %6u %11u cy\n", f.name.c_str(), f.size, lines, lines * waitStates);
+        }
+    }
+    return 0;
+}
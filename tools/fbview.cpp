@@ -0,0 +1,125 @@
+// Host tool: live terminal viewer for the frames a simulator publishes into
+// a shared-memory frame ring (FrameRing.h). The ring is mapped read-only and
+// each frame is rendered straight from its slot, two pixel rows per text
+// row with half-block characters in 24-bit color.
+//
+// Build:   g++ -O2 -std=c++17 -I.. fbview.cpp -o fbview
+// Run:     fbview [-s scale] [-1] /dev/shm/frames
+//
+// -s shrinks the frame by that factor (a cell shows text if any pixel under
+// it does, so thin strokes survive); -1 prints the newest frame and exits.
+// Frames published faster than the terminal refresh are skipped, not queued.
+
+#include "../Framebuffer.h"
+#include "FrameRing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+static const int REFRESH_MS = 33; // Terminal redraw interval
+
+// Downscaled palette index of one cell: any text pixel wins over the key color
+static uint8_t Sample(const uint8_t* pixels, int width, int height, int x0, int y0, int scale) {
+    for (int y = y0; y < y0 + scale && y < height; y++) {
+        for (int x = x0; x < x0 + scale && x < width; x++) {
+            if (pixels[y * width + x] != PALETTE_KEY) return pixels[y * width + x];
+        }
+    }
+    return PALETTE_KEY;
+}
+
+static void AppendColor(std::string& out, const char* prefix, uint8_t index) {
+    uint32_t rgb = paletteRgb[index < PALETTE_SIZE ? index : PALETTE_KEY];
+    char buf[32];
+    snprintf(buf, sizeof(buf), "\x1b[%s;2;%u;%u;%um", prefix, (rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+    out += buf;
+}
+
+// Build the whole frame as one string so the terminal gets a single write
+static void Render(std::string& out, const uint8_t* pixels, int width, int height, int scale) {
+    out = "\x1b[H";
+    for (int y = 0; y < height; y += 2 * scale) {
+        int lastTop = -1, lastBottom = -1;
+        for (int x = 0; x < width; x += scale) {
+            uint8_t top = Sample(pixels, width, height, x, y, scale);
+            uint8_t bottom = Sample(pixels, width, height, x, y + scale, scale);
+            if (top != lastTop) AppendColor(out, "38", top);
+            if (bottom != lastBottom) AppendColor(out, "48", bottom);
+            lastTop = top;
+            lastBottom = bottom;
+            out += "\xe2\x96\x80"; // U+2580 upper half block
+        }
+        out += "\x1b[0m\n";
+    }
+}
+
+static void Usage() {
+    fprintf(stderr, "usage: fbview [-s scale] [-1] frame-ring\n");
+}
+
+int main(int argc, char** argv) {
+    int scale = 2;
+    bool once = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) scale = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-1") == 0) once = true;
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (!path || scale < 1) {
+        Usage();
+        return 2;
+    }
+
+    ImageMap map;
+    if (!map.Open(path, IMAGE_READ)) return 1;
+    const FrameRingHeader* header = (const FrameRingHeader*)map.data;
+    if (map.size < sizeof(FrameRingHeader) || header->magic != FRAME_RING_MAGIC ||
+        map.size < FRAME_RING_ALIGN + (size_t)header->slots * header->slotBytes) {
+        fprintf(stderr, "%s: not a frame ring\n", path);
+        return 1;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    std::string screen;
+    uint64_t shown = 0, skipped = 0, torn = 0;
+    if (!once) printf("\x1b[2J");
+
+    for (;;) {
+        uint64_t newest = header->newest.load(std::memory_order_acquire);
+        if (newest < shown) shown = 0; // Publisher restarted
+        if (newest == 0 || newest == shown) {
+            if (once && newest != 0) return 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds(REFRESH_MS));
+            continue;
+        }
+
+        // Render from the slot in place, then make sure it was not rewritten meanwhile
+        FrameSlot* slot = FrameRingSlot(map.data, header, newest);
+        if (slot->sequence.load(std::memory_order_acquire) != newest) continue;
+        uint64_t virtualUs = slot->virtualUs;
+        Render(screen, FrameRingPixels(slot), header->width, header->height, scale);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != newest) {
+            torn++;
+            continue;
+        }
+
+        if (shown != 0) skipped += newest - shown - 1;
+        shown = newest;
+        fwrite(screen.data(), 1, screen.size(), stdout);
+        printf("frame %llu  t=%.1f s  skipped %llu  torn %llu\x1b[K\n", (unsigned long long)newest, virtualUs / 1e6,
+               (unsigned long long)skipped, (unsigned long long)torn);
+        fflush(stdout);
+        if (once) return 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(REFRESH_MS));
+    }
+}
@@ -0,0 +1,584 @@
+// Host tool: simulates a fleet of boards pressing, saving, losing power and
+// exporting over years of operation, far faster than real time, and reports
+// endurance, press-to-persist latency and data-loss statistics.
+//
+// Build:   g++ -O2 -std=c++17 -pthread -I.. fleetsim.cpp -o fleetsim
+// Run:     fleetsim [-n boards] [-y years] [-p presses/day] [-c power cycles/year]
+//                   [-e export interval days] [-w rated write cycles] [-j threads] [-s seed]
+//                   [-i image directory [-E]] [-b base image] [-B] [-P energy parameter=value ...]
+//
+// Each board runs the firmware's storage path from SimBoard.h against its own
+// EEPROM model, driven by a randomized press trace. Time is virtual: each
+// board has its own SimKernel event queue and only does work at presses,
+// saves, power cycles and exports, so idle frames cost nothing. Results
+// depend only on the seed, not on the thread count. With -i, each board's
+// EEPROM is a mapped file (dir/board00000.bin, ...) left behind for log2col.
+// New files start erased; existing ones are booted from as they were left,
+// so a run can continue an earlier one, unless -E erases them first.
+// With -b, every board starts as a copy-on-write fork of one base image
+// (e.g. a dump of a real board, see ImageMap.h) and the run fails if the
+// base file was modified. -B runs the fleet a second time with the old
+// EEPROM read path (separate address-write and read transactions, no page
+// cache) and fails unless the firmware's path needs fewer bus transactions
+// and bytes.
+// Charge drawn is estimated with SimEnergy.h and reported as mAh/day.
+
+#include "SimBoard.h"
+#include "SimEnergy.h"
+#include "SimKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const uint64_t US_PER_DAY = 86400ULL * 1000000;
+static const uint64_t FRAME_US = 100000;      // Main loop thread_sleep_for(100)
+static const uint64_t BOOT_US = 300000;       // Reset to main() (LCD, USB, RTC init)
+static const uint64_t POWER_OFF_US = 2000000; // Time without power per cycle
+static const uint64_t EXPORT_RETRY_US = 60000000; // Export attempted while the board was off
+static const uint32_t EPOCH_START = 1735689600; // 2025-01-01, as set at boot
+static const int LATENCY_BUCKETS = 1000;      // 1 ms buckets; the last one is open-ended
+
+struct SimConfig {
+    int boards = 1000;
+    double years = 3;
+    double pressesPerDay = 50;
+    double powerCyclesPerYear = 12;
+    double exportDays = 7;
+    uint32_t endurance = SIM_ENDURANCE;       // Lower it to age parts faster
+    int threads = 0;                          // 0 = one per hardware thread
+    uint64_t seed = 1;
+    const char* imageDir = nullptr;           // Keep EEPROM images here
+    bool eraseImages = false;                 // Erase existing images in imageDir first
+    const SimEeprom* base = nullptr;          // Fork every board from this image
+    SimReadPath readPath = SIM_READ_TRACKED;  // How reads reach the part (SimBoard.h)
+    bool pageCache = true;                    // Record reads through the page cache
+    EnergyModel energy;
+};
+
+// -----------------------------
+// Per-Board Results
+// -----------------------------
+
+struct BoardResult {
+    uint64_t presses = 0;
+    uint64_t saved = 0;
+    uint64_t lostBusy = 0;        // Pressed while a save was pending or running
+    uint64_t lostOffline = 0;     // Pressed while booting or powered off
+    uint64_t lostOverwritten = 0; // Ring wrapped before the next export
+    uint64_t lostCorrupt = 0;     // Failed its check at export (wear, torn write)
+    uint64_t powerCycles = 0;
+    uint64_t tornWrites = 0;      // Writes cut during their write cycle
+    uint64_t cutWrites = 0;       // Writes cut during the transfer or issued after the cut
+    uint64_t recoveryErrors = 0;  // Ring head recovered somewhere unexpected
+    uint64_t eepromWrites = 0;
+    uint64_t wornWrites = 0;
+    uint64_t busTransactions = 0;
+    uint64_t busBytes = 0;        // Every byte on the bus, addressing included
+    uint32_t maxPageWrites = 0;
+    uint64_t latencySumUs = 0;
+    uint64_t latencyMaxUs = 0;
+    uint32_t latency[LATENCY_BUCKETS] = {};
+    EnergyMeter energy;
+
+    void AddLatency(uint64_t us) {
+        latencySumUs += us;
+        latencyMaxUs = us > latencyMaxUs ? us : latencyMaxUs;
+        uint64_t bucket = us / 1000;
+        latency[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+    }
+
+    void Merge(const BoardResult& other) {
+        presses += other.presses;
+        saved += other.saved;
+        lostBusy += other.lostBusy;
+        lostOffline += other.lostOffline;
+        lostOverwritten += other.lostOverwritten;
+        lostCorrupt += other.lostCorrupt;
+        powerCycles += other.powerCycles;
+        tornWrites += other.tornWrites;
+        cutWrites += other.cutWrites;
+        recoveryErrors += other.recoveryErrors;
+        eepromWrites += other.eepromWrites;
+        wornWrites += other.wornWrites;
+        busTransactions += other.busTransactions;
+        busBytes += other.busBytes;
+        maxPageWrites = other.maxPageWrites > maxPageWrites ? other.maxPageWrites : maxPageWrites;
+        latencySumUs += other.latencySumUs;
+        latencyMaxUs = other.latencyMaxUs > latencyMaxUs ? other.latencyMaxUs : latencyMaxUs;
+        for (int i = 0; i < LATENCY_BUCKETS; i++) latency[i] += other.latency[i];
+        energy.Merge(other.energy);
+    }
+
+    double LatencyPercentileMs(double p) const {
+        uint64_t total = 0;
+        for (uint32_t n : latency) total += n;
+        uint64_t target = (uint64_t)std::ceil(p * total), seen = 0;
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            seen += latency[i];
+            if (seen >= target && seen > 0) return i + 1;
+        }
+        return 0;
+    }
+};
+
+// -----------------------------
+// Press Traces
+// -----------------------------
+
+// Presses follow a day/night cycle (peak mid-afternoon, near zero at night)
+// and occasionally come in quick bursts, which is what exercises the FSM's
+// handling of presses during a save.
+class PressTrace {
+public:
+    PressTrace(std::mt19937_64& rng, double pressesPerDay) : rng(rng), peakPerUs(2 * pressesPerDay / US_PER_DAY) {}
+
+    uint64_t Next(uint64_t now) {
+        if (burstLeft > 0) {
+            burstLeft--;
+            return now + 50000 + rng() % 350000; // 50-400 ms apart
+        }
+        if (std::uniform_real_distribution<double>(0, 1)(rng) < 0.05) burstLeft = 1 + rng() % 4;
+
+        for (;;) { // Thinning against the peak rate
+            now += (uint64_t)std::exponential_distribution<double>(peakPerUs)(rng) + 1;
+            double hour = (double)(now % US_PER_DAY) / (US_PER_DAY / 24);
+            double rate = 0.5 * (1 + std::cos(2 * M_PI * (hour - 14) / 24));
+            if (std::uniform_real_distribution<double>(0, 1)(rng) < rate) return now;
+        }
+    }
+
+private:
+    std::mt19937_64& rng;
+    double peakPerUs;
+    int burstLeft = 0;
+};
+
+// -----------------------------
+// Board Simulation
+// -----------------------------
+
+static uint64_t ExpDelay(std::mt19937_64& rng, double perYear) {
+    if (perYear <= 0) return UINT64_MAX;
+    return (uint64_t)std::exponential_distribution<double>(perYear / (365 * US_PER_DAY))(rng) + 1;
+}
+
+class BoardSim {
+public:
+    BoardSim(const SimConfig& config, uint64_t id)
+        : config(config), rng(config.seed * 0x9E3779B97F4A7C15ULL + id), storage(eeprom, rng),
+          trace(rng, config.pressesPerDay), rtc(kernel, EPOCH_START), frame(kernel) {
+        if (config.imageDir) {
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/board%05llu.bin", config.imageDir, (unsigned long long)id);
+            if (!eeprom.Open(path, IMAGE_SHARED)) exit(1); // Created files are already erased
+            if (config.eraseImages) eeprom.Erase();
+        } else if (config.base) {
+            if (!eeprom.SnapshotOf(*config.base)) exit(1);
+        }
+        eeprom.SetEndurance(config.endurance, rng);
+        eeprom.readPath = config.readPath;
+        storage.backend.pageCache = config.pageCache;
+    }
+
+    BoardResult Run() {
+        uint64_t end = (uint64_t)(config.years * 365 * US_PER_DAY);
+        exportInterval = (uint64_t)(config.exportDays * US_PER_DAY);
+
+        Boot();
+        kernel.At(trace.Next(0), [this] { Press(); });
+        kernel.After(exportInterval, [this] { ExportEvent(); });
+        kernel.RunUntil(end);
+        Export();
+        CloseIdle(end);
+        result.energy.Eeprom(config.energy, eeprom.transferBytes, eeprom.writeCount);
+
+        result.tornWrites = storage.backend.tornWrites;
+        result.cutWrites = storage.backend.lostWrites;
+        result.eepromWrites = eeprom.writeCount;
+        result.wornWrites = eeprom.wornWrites;
+        result.busTransactions = eeprom.transactions;
+        result.busBytes = eeprom.transferBytes;
+        result.maxPageWrites = eeprom.MaxPageWrites();
+        return result;
+    }
+
+private:
+    const SimConfig& config;
+    SimKernel kernel;
+    std::mt19937_64 rng;
+    SimEeprom eeprom;
+    SimStorage storage;
+    PressTrace trace;
+    SimRtc rtc;                   // Battery-backed, keeps counting through power cycles
+    SimTimeout frame;             // The next main-loop frame that has work to do
+    BoardResult result;
+
+    uint64_t exportInterval = 0;
+    bool powered = true;
+    uint64_t bootAt = 0;          // Reset released (uptime zero)
+    uint64_t onlineAt = 0;        // When main() reaches the FSM loop
+    uint64_t frameAnchor = 0;     // Frames run at frameAnchor + k * FRAME_US
+    uint64_t powerOffAt = 0;      // Next power failure
+    uint64_t pressedAt = 0;       // Press waiting for, or being saved by, a frame
+    bool saving = false;
+    uint64_t sinceExport = 0;     // Records appended since the last export
+    uint64_t idleSince = 0;       // Start of the idle frames not yet charged for
+    int headAtPowerOff = 0;
+    bool lastWriteTorn = false;   // Power failed during the latest record write (torn or cut)
+
+    // Main() up to the FSM loop, then arm the next power failure
+    void Boot() {
+        bootAt = kernel.Now();
+        onlineAt = kernel.Now() + BOOT_US + storage.PowerOn();
+        frameAnchor = onlineAt - FRAME_US;
+        uint64_t delay = ExpDelay(rng, config.powerCyclesPerYear);
+        powerOffAt = delay == UINT64_MAX ? UINT64_MAX : kernel.Now() + delay;
+        if (powerOffAt != UINT64_MAX) kernel.At(powerOffAt, [this] { PowerOff(); });
+
+        uint64_t bootEnd = onlineAt < powerOffAt ? onlineAt : powerOffAt;
+        result.energy.Span(config.energy, SIM_BOOT, (double)(bootEnd - kernel.Now()), 0);
+        idleSince = onlineAt;
+    }
+
+    // Charge for the idle frames since idleSince: a short burst of work
+    // and a refresh, then thread_sleep_for until the next frame
+    void CloseIdle(uint64_t at) {
+        if (at <= idleSince) return;
+        double span = (double)(at - idleSince);
+        double frames = span / FRAME_US;
+        double active = std::min(span, frames * config.energy.frameActiveUs);
+        result.energy.Span(config.energy, SIM_IDLE, active, span - active);
+        result.energy.Refreshes(config.energy, frames);
+        idleSince = at;
+    }
+
+    // A press is saved by the first frame after it; presses until that save
+    // completes find the FSM in SAVE_TIME and are dropped. Idle frames change
+    // nothing, so only the frame that saves is scheduled.
+    void Press() {
+        uint64_t now = kernel.Now();
+        result.presses++;
+        kernel.At(trace.Next(now), [this] { Press(); });
+
+        if (!powered || now < onlineAt) {
+            result.lostOffline++;
+        } else if (saving) {
+            result.lostBusy++;
+        } else {
+            saving = true;
+            pressedAt = now;
+            uint64_t next = frameAnchor + ((now - frameAnchor + FRAME_US - 1) / FRAME_US) * FRAME_US;
+            frame.attach_us([this] { Save(); }, next - now);
+        }
+    }
+
+    // SAVE_TIME: the main thread blocks on the EEPROM while presses, power
+    // failures and exports keep arriving
+    void Save() {
+        LogRecord record = {};
+        record.epoch = rtc.time();
+        record.tag = LOG_CHANNEL_USER;
+
+        // Power may fail in any of the append's writes (record, index,
+        // checkpoint); the backend tears or drops whichever one it lands in.
+        // The record write comes first, so only it decides head recovery.
+        uint64_t recordUs = (3 + LOG_RECORD_SIZE) * SIM_I2C_BYTE_US + SIM_WRITE_CYCLE_US;
+        lastWriteTorn = powerOffAt < kernel.Now() + recordUs;
+        storage.PowerFailIn(powerOffAt == UINT64_MAX ? UINT64_MAX : powerOffAt - kernel.Now());
+        storage.backend.uptimeSeconds = (uint32_t)((kernel.Now() - bootAt) / 1000000);
+        uint64_t cycles = result.powerCycles;
+        uint32_t writes = eeprom.writeCount;
+        CloseIdle(kernel.Now());
+        idleSince = UINT64_MAX;
+        sinceExport++;
+
+        // The bus transfers run the MCU; it sleeps through the write cycles
+        uint64_t busyUs = storage.LogAppend(record);
+        storage.PowerFailIn(UINT64_MAX);
+        double sleepUs = (double)(eeprom.writeCount - writes) * SIM_WRITE_CYCLE_US;
+        result.energy.Span(config.energy, SIM_SAVE, busyUs - sleepUs, sleepUs);
+        result.energy.Refreshes(config.energy, 1);
+        kernel.Sleep(busyUs);
+
+        if (result.powerCycles != cycles) {
+            result.lostOffline++;
+            return;
+        }
+        saving = false;
+        frameAnchor = kernel.Now();
+        idleSince = kernel.Now();
+        result.saved++;
+        result.AddLatency(kernel.Now() - pressedAt);
+    }
+
+    void PowerOff() {
+        result.powerCycles++;
+        powered = false;
+        headAtPowerOff = storage.log.logHead;
+        if (frame.pending()) result.lostOffline++; // Pressed, but the saving frame never ran
+        frame.detach();
+        saving = false;
+        CloseIdle(kernel.Now());
+        idleSince = UINT64_MAX;
+        kernel.After(POWER_OFF_US, [this] { PowerOn(); });
+    }
+
+    // RAM is lost; the ring head must come back where it was, or one slot
+    // back if the last record write was torn. (The count may legitimately
+    // differ: a torn slot in a full ring hides the older lap until rewritten.)
+    void PowerOn() {
+        powered = true;
+        Boot();
+        bool tornSlot = storage.log.logHead == (headAtPowerOff - 1 + LOG_CAPACITY) % LOG_CAPACITY;
+        if (storage.log.logHead != headAtPowerOff && !(lastWriteTorn && tornSlot)) result.recoveryErrors++;
+        lastWriteTorn = false;
+    }
+
+    // The user plugs the board in every exportInterval, retrying while it is off
+    void ExportEvent() {
+        if (!powered || kernel.Now() < onlineAt) {
+            kernel.After(EXPORT_RETRY_US, [this] { ExportEvent(); });
+            return;
+        }
+        Export();
+        kernel.After(exportInterval, [this] { ExportEvent(); });
+    }
+
+    // Download the log: records appended since the last export must still be
+    // in the ring and pass their check
+    void Export() {
+        uint64_t inRing = sinceExport < (uint64_t)storage.log.logCount ? sinceExport : storage.log.logCount;
+        result.lostOverwritten += sinceExport - inRing;
+
+        LogRecord record;
+        for (uint64_t age = 0; age < inRing; age++) {
+            if (!storage.LogReadNewest((int)age, &record)) result.lostCorrupt++;
+        }
+        sinceExport = 0;
+    }
+};
+
+// -----------------------------
+// Work-Stealing Pool
+// -----------------------------
+
+// Each worker owns a deque of task indices, takes work from its back and,
+// when empty, steals from the front of the others. Boards differ a lot in
+// cost (press rates, power cycles), so static partitioning would leave
+// threads idle near the end.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threads) : queues(threads) {}
+
+    void Run(size_t tasks, const std::function<void(size_t)>& work) {
+        for (size_t i = 0; i < tasks; i++) queues[i % queues.size()].tasks.push_back(i);
+
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < queues.size(); w++) {
+            workers.emplace_back([this, w, &work] {
+                size_t task;
+                while (Take(w, &task)) work(task);
+            });
+        }
+        for (std::thread& t : workers) t.join();
+    }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+    std::vector<Queue> queues;
+
+    bool Take(size_t self, size_t* task) {
+        {
+            std::lock_guard<std::mutex> guard(queues[self].lock);
+            if (!queues[self].tasks.empty()) {
+                *task = queues[self].tasks.back();
+                queues[self].tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); k++) {
+            Queue& victim = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                *task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false; // Tasks are never added during Run, so empty everywhere means done
+    }
+};
+
+// -----------------------------
+// Main
+// -----------------------------
+
+static void Usage() {
+    fprintf(stderr, "usage: fleetsim [-n boards] [-y years] [-p presses/day] [-c power cycles/year]\n"
+                    "                [-e export interval days] [-w rated write cycles] [-j threads] [-s seed]\n"
+                    "                [-i image directory [-E]] [-b base image] [-B] [-P energy parameter=value ...]\n"
+                    "energy parameters: %s\n",
+            EnergyModel::Names());
+}
+
+// FNV-1a over the whole image, to tell whether the base was written to
+static uint64_t ImageHash(const SimEeprom& eeprom) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (uint32_t i = 0; i < eeprom.Size(); i++) h = (h ^ eeprom.image.data[i]) * 0x100000001B3ULL;
+    return h;
+}
+
+// Simulate every board; returns the wall time taken in seconds
+static double RunFleet(const SimConfig& config, std::vector<BoardResult>* results) {
+    auto start = std::chrono::steady_clock::now();
+    results->assign(config.boards, BoardResult());
+    WorkStealingPool pool(config.threads);
+    pool.Run(config.boards, [&](size_t board) { (*results)[board] = BoardSim(config, board).Run(); });
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double Percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+int main(int argc, char** argv) {
+    SimConfig config;
+    const char* baseImage = nullptr;
+    bool compareBus = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-E") == 0) {
+            config.eraseImages = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-B") == 0) {
+            compareBus = true;
+            continue;
+        }
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            Usage();
+            return 2;
+        }
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'n': config.boards = atoi(value); break;
+            case 'y': config.years = atof(value); break;
+            case 'p': config.pressesPerDay = atof(value); break;
+            case 'c': config.powerCyclesPerYear = atof(value); break;
+            case 'e': config.exportDays = atof(value); break;
+            case 'w': config.endurance = (uint32_t)strtoul(value, nullptr, 10); break;
+            case 'j': config.threads = atoi(value); break;
+            case 's': config.seed = strtoull(value, nullptr, 10); break;
+            case 'i': config.imageDir = value; break;
+            case 'b': baseImage = value; break;
+            case 'P':
+                if (!config.energy.Set(value)) {
+                    Usage();
+                    return 2;
+                }
+                break;
+            default: Usage(); return 2;
+        }
+    }
+    if (config.threads <= 0) config.threads = std::max(1u, std::thread::hardware_concurrency());
+    if ((config.eraseImages && !config.imageDir) || (baseImage && config.imageDir)) {
+        Usage();
+        return 2;
+    }
+
+    SimEeprom base;
+    uint64_t baseHash = 0;
+    if (baseImage) {
+        if (!base.Open(baseImage, IMAGE_READ)) return 1;
+        baseHash = ImageHash(base);
+        config.base = &base;
+    }
+
+    // Same boards and traces on the old read path, without touching any image files
+    BoardResult legacy;
+    if (compareBus) {
+        SimConfig old = config;
+        old.imageDir = nullptr;
+        old.readPath = SIM_READ_SPLIT;
+        old.pageCache = false;
+        std::vector<BoardResult> oldResults;
+        RunFleet(old, &oldResults);
+        for (const BoardResult& r : oldResults) legacy.Merge(r);
+    }
+
+    std::vector<BoardResult> results;
+    double seconds = RunFleet(config, &results);
+
+    BoardResult fleet;
+    std::vector<uint32_t> hottest;
+    int wornBoards = 0;
+    for (const BoardResult& r : results) {
+        fleet.Merge(r);
+        hottest.push_back(r.maxPageWrites);
+        if (r.wornWrites) wornBoards++;
+    }
+    std::sort(hottest.begin(), hottest.end());
+    double boardYears = config.boards * config.years;
+    uint64_t lost = fleet.lostBusy + fleet.lostOffline + fleet.lostOverwritten + fleet.lostCorrupt;
+
+    printf("boards          %d x %.1f years on %d threads: %.2f s (%.0f board-years/s, %.2g x real time)\n",
+           config.boards, config.years, config.threads, seconds, boardYears / seconds,
+           boardYears * 365 * 86400 / seconds);
+    printf("presses         %llu, saved %llu (%.3f%%)\n", (unsigned long long)fleet.presses,
+           (unsigned long long)fleet.saved, Percent(fleet.saved, fleet.presses));
+    printf("lost            %llu (%.3f%%): busy %llu, offline %llu, overwritten %llu, corrupt %llu\n",
+           (unsigned long long)lost, Percent(lost, fleet.presses), (unsigned long long)fleet.lostBusy,
+           (unsigned long long)fleet.lostOffline, (unsigned long long)fleet.lostOverwritten,
+           (unsigned long long)fleet.lostCorrupt);
+    printf("latency ms      mean %.1f, p50 %.0f, p99 %.0f, max %.1f\n",
+           fleet.saved ? fleet.latencySumUs / 1000.0 / fleet.saved : 0.0, fleet.LatencyPercentileMs(0.5),
+           fleet.LatencyPercentileMs(0.99), fleet.latencyMaxUs / 1000.0);
+    printf("power cycles    %llu, torn writes %llu, cut writes %llu, recovery errors %llu\n",
+           (unsigned long long)fleet.powerCycles, (unsigned long long)fleet.tornWrites,
+           (unsigned long long)fleet.cutWrites, (unsigned long long)fleet.recoveryErrors);
+    if (!hottest.empty()) {
+        uint32_t worst = hottest.back(), median = hottest[hottest.size() / 2];
+        printf("hottest page    median %u, worst %u writes; worst-board life %.1f years at %lu cycles\n", median,
+               worst, worst ? config.years * config.endurance / worst : INFINITY, (unsigned long)config.endurance);
+    }
+    printf("eeprom writes   %llu, %d boards with worn pages (%llu writes)\n", (unsigned long long)fleet.eepromWrites,
+           wornBoards, (unsigned long long)fleet.wornWrites);
+
+    const EnergyMeter& e = fleet.energy;
+    double boardDays = boardYears * 365;
+    auto perDay = [&](double uc) { return EnergyMeter::ToMah(uc) / boardDays; };
+    printf("energy mAh/day  %.1f (%.1f mA average): boot %.3g, idle %.4g, save %.3g, lcd %.4g, refresh %.3g, "
+           "i2c %.3g, eeprom %.3g\n",
+           perDay(e.TotalUc()), perDay(e.TotalUc()) / 24, perDay(e.stateUc[SIM_BOOT]), perDay(e.stateUc[SIM_IDLE]),
+           perDay(e.stateUc[SIM_SAVE]), perDay(e.lcdUc), perDay(e.refreshUc), perDay(e.i2cUc), perDay(e.eepromUc));
+    printf("i2c bus         %llu transactions, %llu bytes\n", (unsigned long long)fleet.busTransactions,
+           (unsigned long long)fleet.busBytes);
+
+    if (compareBus) {
+        bool fewer = fleet.busTransactions < legacy.busTransactions && fleet.busBytes < legacy.busBytes;
+        printf("old read path   %llu transactions, %llu bytes: %.1f%% fewer transactions, %.1f%% fewer bytes%s\n",
+               (unsigned long long)legacy.busTransactions, (unsigned long long)legacy.busBytes,
+               100 - Percent(fleet.busTransactions, legacy.busTransactions),
+               100 - Percent(fleet.busBytes, legacy.busBytes), fewer ? "" : " (NO REDUCTION)");
+        if (!fewer) return 1;
+    }
+
+    if (baseImage) {
+        bool unchanged = ImageHash(base) == baseHash;
+        printf("base image      %s, %d boards forked: %s\n", baseImage, config.boards,
+               unchanged ? "unchanged" : "MODIFIED");
+        if (!unchanged) return 1;
+    }
+    return 0;
+}
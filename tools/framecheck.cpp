@@ -0,0 +1,418 @@
+// Host tool: golden-frame regression check for the display. Each scenario
+// scripts the firmware's screens (Screens.h) on the mock LCD (SimLcd.h) in
+// virtual time, hashes every composed frame and compares it with
+// golden/<scenario>.txt. Matching frames cost one hash; a frame that differs
+// is written as a PNG.
+//
+// Build:   g++ -O2 -std=c++17 -I.. framecheck.cpp -o framecheck
+// Check:   framecheck [-g golden dir] [-o png dir] [scenario ...]
+// Update:  framecheck -u [-g golden dir] [scenario ...]   (after an intended change)
+// Watch:   framecheck -p /dev/shm/frames [-x speed] & fbview /dev/shm/frames
+//
+// The screens are the firmware's own code; the scenarios model the state
+// they are drawn from (clock state, lap queue, log, telemetry) the way the
+// firmware's main loop and ISRs update it.
+//
+// With -p, every frame is composed straight into a shared-memory frame ring
+// (FrameRing.h) for fbview to display; -x paces virtual time at that multiple
+// of real time instead of running flat out.
+//
+// Golden file: one "frame hash" line per run of identical frames (the frame
+// number where the run starts, 64-bit hash in hex), then "frames <count>".
+
+#include "../Screens.h"
+#include "FrameRing.h"
+#include "SimBoard.h"
+#include "SimKernel.h"
+#include "SimLcd.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint64_t FRAME_US = 100000;       // Main loop refresh interval
+static const uint32_t EPOCH_START = 1735689590; // 2024-12-31 23:59:50, just before two rollovers
+static const int MAX_DUMPS = 3;                 // PNGs written per failing scenario
+
+// -----------------------------
+// Frame Checking
+// -----------------------------
+
+struct Run {
+    uint64_t frame;
+    uint64_t hash;
+};
+
+// Where frames go besides the check: an optional live ring and pacing
+struct FrameOutput {
+    FramePublisher* ring = nullptr;
+    double speed = 0;              // Virtual seconds per real second, 0 = flat out
+};
+
+// Collects one hash per frame and compares it with the golden runs as it goes
+class FrameSink {
+public:
+    std::vector<Run> runs; // Actual frames, run-length encoded
+    uint64_t frames = 0;
+    uint64_t mismatches = 0;
+    std::vector<uint64_t> dumped;
+
+    FrameSink(const std::string& name, const std::vector<Run>* golden, const char* pngDir, const FrameOutput& output)
+        : name(name), golden(golden), pngDir(pngDir), output(output), pixels(SIM_LCD_WIDTH * SIM_LCD_HEIGHT) {}
+
+    void Frame(SimLcd& lcd, uint64_t nowUs) {
+        uint8_t* frame = output.ring ? output.ring->Begin() : pixels.data();
+        lcd.ComposeInto(frame);
+        uint64_t hash = FrameHash(frame, pixels.size());
+        if (output.ring) output.ring->Commit(nowUs);
+        if (output.speed > 0) Pace(nowUs);
+        if (runs.empty() || runs.back().hash != hash) runs.push_back(Run{frames, hash});
+
+        if (golden && hash != Expected(frames)) {
+            mismatches++;
+            if ((int)dumped.size() < MAX_DUMPS) {
+                char path[1024];
+                snprintf(path, sizeof(path), "%s/%s-%05llu.png", pngDir, name.c_str(), (unsigned long long)frames);
+                if (WritePng(path, frame, SIM_LCD_WIDTH, SIM_LCD_HEIGHT)) dumped.push_back(frames);
+            }
+        }
+        frames++;
+    }
+
+private:
+    std::string name;
+    const std::vector<Run>* golden;
+    const char* pngDir;
+    FrameOutput output;
+    std::vector<uint8_t> pixels; // Composed frame when there is no ring
+    size_t cursor = 0;           // Golden run containing the current frame
+    std::chrono::steady_clock::time_point wallStart;
+
+    void Pace(uint64_t nowUs) {
+        if (frames == 0) wallStart = std::chrono::steady_clock::now() - std::chrono::microseconds((int64_t)(nowUs / output.speed));
+        std::this_thread::sleep_until(wallStart + std::chrono::microseconds((int64_t)(nowUs / output.speed)));
+    }
+
+    uint64_t Expected(uint64_t frame) {
+        while (cursor + 1 < golden->size() && (*golden)[cursor + 1].frame <= frame) cursor++;
+        return golden->empty() ? 0 : (*golden)[cursor].hash;
+    }
+};
+
+// -----------------------------
+// Scenarios
+// -----------------------------
+
+// Virtual board for one scenario, with scripted button events scheduled on
+// its kernel
+struct Rig {
+    SimKernel kernel;             // Bound to this thread, so thread_sleep_for runs on it
+    SimRtc rtc{kernel, EPOCH_START};
+    SimLcd lcd;
+};
+
+// The firmware's FSM loop: a frame, then thread_sleep_for(100), during which
+// the events due in that interval (button ISRs, the lap queue filling) run
+static void MainLoop(Rig& rig, uint64_t end, const std::function<void()>& frame) {
+    while (rig.kernel.Now() < end) {
+        frame();
+        thread_sleep_for(FRAME_US / 1000);
+    }
+}
+
+// Clock across a minute, hour, day and year rollover
+static void ScenarioClock(FrameSink& sink) {
+    Rig rig;
+    MainLoop(rig, 180 * 1000000ULL, [&] {
+        ShowTime(rig.lcd, rig.rtc.time());
+        sink.Frame(rig.lcd, rig.kernel.Now());
+    });
+}
+
+// Field cycling and increments with the field markers moving
+static void ScenarioSetTime(FrameSink& sink) {
+    Rig rig;
+    uint32_t selected = EPOCH_START;
+    int field = 0;
+    for (int i = 1; i <= 60; i++) {
+        rig.kernel.At(i * 500000ULL, [&, i] {
+            if (i % 7 == 0) field = (field + 1) % 3;
+            else selected += field == 0 ? 3600 : field == 1 ? 60 : 1;
+        });
+    }
+    MainLoop(rig, 32 * 1000000ULL, [&] {
+        SetTime(rig.lcd, selected, field);
+        sink.Frame(rig.lcd, rig.kernel.Now());
+    });
+}
+
+// Log history scrolled past the end of the log and back
+static void ScenarioHistory(FrameSink& sink) {
+    Rig rig;
+    std::mt19937_64 rng(1);
+    SimEeprom eeprom;
+    SimStorage storage(eeprom, rng);
+    storage.PowerOn();
+    for (int i = 0; i < 29; i++) {
+        LogRecord record = {};
+        record.epoch = EPOCH_START - 86400 + i * 2917;
+        storage.LogAppend(record);
+    }
+
+    int offset = 0;
+    for (int i = 1; i <= 12; i++) {
+        rig.kernel.At(i * 1000000ULL, [&, i] { offset = i <= 6 ? offset + HISTORY_ROWS / 2 : offset - HISTORY_ROWS / 2; });
+    }
+    MainLoop(rig, 14 * 1000000ULL, [&] {
+        ShowPreviousTimes(rig.lcd, storage, offset);
+        sink.Frame(rig.lcd, rig.kernel.Now());
+    });
+}
+
+// Start, laps, stop and reset, with the start off the frame grid so the
+// hundredths move. As on the board, presses update the clock state at once
+// while laps reach the log (and lapsRecorded) only after the next frame, so
+// a fresh lap shows "L--" for one frame.
+static void ScenarioStopwatch(FrameSink& sink) {
+    Rig rig;
+    bool running = false;
+    uint64_t startUs = 0, baseUs = 0, lastLapUs = 0;
+    int lapCount = 0;                         // ClockState, written by the FSM actions
+    std::vector<std::pair<int, uint64_t>> queue; // Lap number and split waiting for LapDrain
+    int lapsRecorded = 0;
+    uint64_t newestSplitUs = 0;
+    auto elapsed = [&] { return baseUs + (running ? rig.kernel.Now() - startUs : 0); };
+
+    auto toggle = [&] {
+        if (running) baseUs = elapsed();
+        else startUs = rig.kernel.Now();
+        running = !running;
+    };
+    auto lap = [&] {
+        uint64_t t = elapsed();
+        queue.push_back({++lapCount, t - lastLapUs});
+        lastLapUs = t;
+    };
+    rig.kernel.At(1037000, toggle);
+    for (uint64_t at : {4210000ULL, 9999000ULL, 10001000ULL, 38500000ULL, 61234000ULL}) rig.kernel.At(at, lap);
+    rig.kernel.At(75003000, toggle);
+    rig.kernel.At(80000000, toggle);
+    rig.kernel.At(95555000, lap);
+    rig.kernel.At(100000000, toggle);
+    rig.kernel.At(105000000, [&] {
+        baseUs = lastLapUs = 0;
+        lapCount = 0;
+    });
+    rig.kernel.At(105550000, toggle);
+    rig.kernel.At(106012000, lap); // First lap of a new run replaces the old run's laps
+
+    MainLoop(rig, 108 * 1000000ULL, [&] {
+        ShowStopwatch(rig.lcd, elapsed(), lapCount, lapsRecorded, newestSplitUs);
+        sink.Frame(rig.lcd, rig.kernel.Now());
+
+        for (const auto& queued : queue) { // LapDrain
+            if (queued.first == 1) lapsRecorded = 0;
+            lapsRecorded = queued.first;
+            newestSplitUs = queued.second;
+        }
+        queue.clear();
+    });
+}
+
+// Wear report while presses are logged, through the first telemetry
+// checkpoint. Lines past the wear report are board counters with no host
+// counterpart.
+static void ScenarioDiagnostics(FrameSink& sink) {
+    Rig rig;
+    std::mt19937_64 rng(3);
+    SimEeprom eeprom;
+    SimStorage storage(eeprom, rng);
+    storage.PowerOn();
+
+    for (int i = 1; i <= 80; i++) {
+        rig.kernel.At(i * 300000ULL, [&] {
+            LogRecord record = {};
+            record.epoch = rig.rtc.time();
+            storage.backend.uptimeSeconds = (uint32_t)(rig.kernel.Now() / 1000000);
+            storage.LogAppend(record);
+        });
+    }
+    auto lines = [&](int line, char* out) {
+        const Telemetry& t = storage.backend.telemetry;
+        return WearLine(t, t.baseSeconds + rig.kernel.Now() / 1000000, line, out);
+    };
+    MainLoop(rig, 26 * 1000000ULL, [&] {
+        ShowDiagnostics(rig.lcd, lines);
+        sink.Frame(rig.lcd, rig.kernel.Now());
+    });
+}
+
+// Every screen in turn, re-entering each so stale window contents would show
+static void ScenarioTour(FrameSink& sink) {
+    Rig rig;
+    std::mt19937_64 rng(2);
+    SimEeprom eeprom;
+    SimStorage storage(eeprom, rng);
+    storage.PowerOn();
+
+    int screen = SCREEN_TIME;
+    const int order[] = {SCREEN_TIME, SCREEN_HISTORY, SCREEN_STOPWATCH, SCREEN_DIAGNOSTICS, SCREEN_SET_TIME};
+    for (int i = 1; i <= 20; i++) {
+        rig.kernel.At(i * 1500000ULL, [&, i] { screen = order[i % 5]; });
+        rig.kernel.At(i * 1500000ULL - 700000, [&] { // A press saved between screens
+            LogRecord record = {};
+            record.epoch = rig.rtc.time();
+            storage.LogAppend(record);
+        });
+    }
+    auto lines = [&](int line, char* out) {
+        return WearLine(storage.backend.telemetry, rig.kernel.Now() / 1000000, line, out);
+    };
+    MainLoop(rig, 32 * 1000000ULL, [&] {
+        switch (screen) {
+            case SCREEN_TIME: ShowTime(rig.lcd, rig.rtc.time()); break;
+            case SCREEN_HISTORY: ShowPreviousTimes(rig.lcd, storage, 0); break;
+            case SCREEN_STOPWATCH: ShowStopwatch(rig.lcd, rig.kernel.Now(), 0, 0, 0); break;
+            case SCREEN_DIAGNOSTICS: ShowDiagnostics(rig.lcd, lines); break;
+            case SCREEN_SET_TIME: SetTime(rig.lcd, rig.rtc.time(), (int)(rig.kernel.Now() / 1000000) % 3); break;
+        }
+        sink.Frame(rig.lcd, rig.kernel.Now());
+    });
+}
+
+static const struct {
+    const char* name;
+    void (*run)(FrameSink&);
+} scenarios[] = {
+    {"clock", ScenarioClock},
+    {"settime", ScenarioSetTime},
+    {"history", ScenarioHistory},
+    {"stopwatch", ScenarioStopwatch},
+    {"diagnostics", ScenarioDiagnostics},
+    {"tour", ScenarioTour},
+};
+
+// -----------------------------
+// Golden Files
+// -----------------------------
+
+static bool LoadGolden(const std::string& path, std::vector<Run>* runs, uint64_t* frames) {
+    FILE* in = fopen(path.c_str(), "r");
+    if (!in) return false;
+
+    char line[128];
+    while (fgets(line, sizeof(line), in)) {
+        unsigned long long frame, hash;
+        if (sscanf(line, "frames %llu", &frame) == 1) *frames = frame;
+        else if (sscanf(line, "%llu %llx", &frame, &hash) == 2) runs->push_back(Run{frame, hash});
+    }
+    fclose(in);
+    return true;
+}
+
+static bool SaveGolden(const std::string& path, const FrameSink& sink) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) {
+        perror(path.c_str());
+        return false;
+    }
+    for (const Run& run : sink.runs) fprintf(out, "%llu %016" PRIx64 "\n", (unsigned long long)run.frame, run.hash);
+    fprintf(out, "frames %llu\n", (unsigned long long)sink.frames);
+    return fclose(out) == 0;
+}
+
+// -----------------------------
+// Main
+// -----------------------------
+
+static void Usage() {
+    fprintf(stderr, "usage: framecheck [-u] [-g golden dir] [-o png dir] [-p frame ring] [-x speed] [scenario ...]\n"
+                    "scenarios:");
+    for (const auto& s : scenarios) fprintf(stderr, " %s", s.name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+    bool update = false;
+    const char* goldenDir = "golden";
+    const char* pngDir = ".";
+    std::vector<std::string> selected;
+    FramePublisher ring;
+    FrameOutput output;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-u") == 0) update = true;
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) goldenDir = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) pngDir = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            if (!ring.Open(argv[++i], SIM_LCD_WIDTH, SIM_LCD_HEIGHT)) return 1;
+            output.ring = &ring;
+        } else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc) output.speed = atof(argv[++i]);
+        else if (argv[i][0] == '-') {
+            Usage();
+            return 2;
+        } else {
+            selected.push_back(argv[i]);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t totalFrames = 0;
+    int failed = 0, matched = 0;
+
+    for (const auto& scenario : scenarios) {
+        if (!selected.empty()) {
+            bool wanted = false;
+            for (const std::string& name : selected) wanted |= name == scenario.name;
+            if (!wanted) continue;
+        }
+        matched++;
+        std::string path = std::string(goldenDir) + "/" + scenario.name + ".txt";
+
+        std::vector<Run> golden;
+        uint64_t goldenFrames = 0;
+        bool haveGolden = !update && LoadGolden(path, &golden, &goldenFrames);
+        if (!update && !haveGolden) {
+            printf("%-10s no golden file %s (run with -u to create it)\n", scenario.name, path.c_str());
+            failed++;
+            continue;
+        }
+
+        FrameSink sink(scenario.name, haveGolden ? &golden : nullptr, pngDir, output);
+        scenario.run(sink);
+        totalFrames += sink.frames;
+
+        if (update) {
+            if (!SaveGolden(path, sink)) return 1;
+            printf("%-10s %6llu frames, %zu distinct runs written\n", scenario.name, (unsigned long long)sink.frames,
+                   sink.runs.size());
+            continue;
+        }
+        if (sink.mismatches == 0 && sink.frames == goldenFrames) {
+            printf("%-10s %6llu frames ok\n", scenario.name, (unsigned long long)sink.frames);
+            continue;
+        }
+
+        failed++;
+        printf("%-10s FAIL: %llu of %llu frames differ", scenario.name, (unsigned long long)sink.mismatches,
+               (unsigned long long)sink.frames);
+        if (sink.frames != goldenFrames) printf(", expected %llu frames", (unsigned long long)goldenFrames);
+        for (uint64_t frame : sink.dumped) printf(" %s/%s-%05llu.png", pngDir, scenario.name, (unsigned long long)frame);
+        printf("\n");
+    }
+
+    if (matched == 0) {
+        Usage();
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu frames in %.2f s (%.0f frames/s)\n", (unsigned long long)totalFrames, seconds,
+            seconds > 0 ? totalFrames / seconds : 0.0);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,337 @@
+// Host tool: converts raw EEPROM images pulled from devices (USB command 'b')
+// into a compact columnar file, or decodes such a file back to CSV.
+//
+// Build:   g++ -O2 -std=c++17 -I.. log2col.cpp -o log2col
+// Encode:  log2col -o fleet.col board1.bin board2.bin ...
+// Decode:  log2col -d fleet.col > fleet.csv
+//
+// Each input file may hold several concatenated images; the device column is
+// the image's position across all inputs. Records are decoded with the same
+// LogFormat.h the firmware writes them with.
+//
+// File layout (all integers little-endian):
+//   "LOGCOL1\n"
+//   row group*:  u32 rows, then per column (epoch, subsecond, channel, device):
+//                u32 byte length + delta/bit-packed values
+//   u32 0        end marker
+//
+// Column encoding: zigzag varint of the first value, then the deltas in
+// blocks of 128 as zigzag varint minimum delta, u8 bit width and the
+// (delta - minimum) values packed LSB-first at that width.
+
+#include "../LogFormat.h"
+#include "ImageMap.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const char MAGIC[8] = {'L', 'O', 'G', 'C', 'O', 'L', '1', '\n'};
+static const int COLUMNS = 4;
+static const size_t ROW_GROUP = 65536;
+static const size_t DELTA_BLOCK = 128;
+
+// -----------------------------
+// Column Encoding
+// -----------------------------
+
+static uint64_t ZigZag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t UnZigZag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static void EncodeColumn(const std::vector<int64_t>& values, std::vector<uint8_t>& out) {
+    out.clear();
+    if (values.empty()) return;
+    PutVarint(out, ZigZag(values[0]));
+
+    for (size_t start = 1; start < values.size(); start += DELTA_BLOCK) {
+        size_t end = start + DELTA_BLOCK < values.size() ? start + DELTA_BLOCK : values.size();
+
+        int64_t minDelta = values[start] - values[start - 1];
+        for (size_t i = start + 1; i < end; i++) {
+            int64_t d = values[i] - values[i - 1];
+            if (d < minDelta) minDelta = d;
+        }
+
+        uint64_t maxOffset = 0;
+        for (size_t i = start; i < end; i++) {
+            uint64_t offset = (uint64_t)(values[i] - values[i - 1] - minDelta);
+            if (offset > maxOffset) maxOffset = offset;
+        }
+        int width = 0;
+        while (width < 64 && (maxOffset >> width) != 0) width++;
+
+        PutVarint(out, ZigZag(minDelta));
+        out.push_back((uint8_t)width);
+
+        uint64_t acc = 0;
+        int bits = 0;
+        for (size_t i = start; i < end; i++) {
+            uint64_t offset = (uint64_t)(values[i] - values[i - 1] - minDelta);
+            for (int b = 0; b < width; b++) {
+                acc |= ((offset >> b) & 1) << bits;
+                if (++bits == 8) {
+                    out.push_back((uint8_t)acc);
+                    acc = 0;
+                    bits = 0;
+                }
+            }
+        }
+        if (bits) out.push_back((uint8_t)acc);
+    }
+}
+
+// Cursor over one encoded column
+class ColumnReader {
+public:
+    ColumnReader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+    bool Decode(size_t rows, std::vector<int64_t>& values) {
+        values.clear();
+        if (rows == 0) return true;
+
+        uint64_t raw;
+        if (!Varint(&raw)) return false;
+        values.push_back(UnZigZag(raw));
+
+        while (values.size() < rows) {
+            size_t count = rows - values.size() < DELTA_BLOCK ? rows - values.size() : DELTA_BLOCK;
+            if (!Varint(&raw) || p == end) return false;
+            int64_t minDelta = UnZigZag(raw);
+            int width = *p++;
+
+            uint64_t acc = 0;
+            int bits = 0;
+            for (size_t i = 0; i < count; i++) {
+                uint64_t offset = 0;
+                for (int b = 0; b < width; b++) {
+                    if (bits == 0) {
+                        if (p == end) return false;
+                        acc = *p++;
+                        bits = 8;
+                    }
+                    offset |= (acc & 1) << b;
+                    acc >>= 1;
+                    bits--;
+                }
+                values.push_back(values.back() + minDelta + (int64_t)offset);
+            }
+        }
+        return true;
+    }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool Varint(uint64_t* v) {
+        *v = 0;
+        for (int shift = 0; p != end && shift < 64; shift += 7) {
+            uint8_t byte = *p++;
+            *v |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+};
+
+// -----------------------------
+// Writer
+// -----------------------------
+
+class ColumnWriter {
+public:
+    explicit ColumnWriter(FILE* out) : file(out), rows(0) {
+        fwrite(MAGIC, 1, sizeof(MAGIC), file);
+    }
+
+    void Append(uint32_t device, const LogRecord& record) {
+        columns[0].push_back(record.epoch);
+        columns[1].push_back(record.subsecond);
+        columns[2].push_back(record.tag & TAG_CHANNEL_MASK);
+        columns[3].push_back(device);
+        if (columns[0].size() == ROW_GROUP) Flush();
+        rows++;
+    }
+
+    uint64_t Finish() {
+        Flush();
+        PutU32(0);
+        return rows;
+    }
+
+private:
+    FILE* file;
+    uint64_t rows;
+    std::vector<int64_t> columns[COLUMNS];
+    std::vector<uint8_t> encoded;
+
+    void PutU32(uint32_t v) {
+        uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+        fwrite(b, 1, sizeof(b), file);
+    }
+
+    void Flush() {
+        if (columns[0].empty()) return;
+        PutU32((uint32_t)columns[0].size());
+        for (int c = 0; c < COLUMNS; c++) {
+            EncodeColumn(columns[c], encoded);
+            PutU32((uint32_t)encoded.size());
+            fwrite(encoded.data(), 1, encoded.size(), file);
+            columns[c].clear();
+        }
+    }
+};
+
+// Decode every image in one dump file, oldest record first per device. The
+// file is mapped rather than read, so records are decoded in place.
+static bool EncodeFile(const char* path, ColumnWriter& writer, uint32_t* device) {
+    ImageMap file;
+    if (!file.Open(path, IMAGE_READ)) return false;
+
+    size_t offset = 0;
+    for (; offset + EEPROM_SIZE <= file.size; offset += EEPROM_SIZE) {
+        const LogRecord* image = (const LogRecord*)(file.data + offset);
+        const LogRecord* ring = &image[LOG_BASE / LOG_RECORD_SIZE];
+        uint32_t generation = LogGeneration((const LogHeader*)&image[LOG_HEADER / LOG_RECORD_SIZE]);
+
+        LogScan scan(generation);
+        for (int slot = 0; slot < LOG_CAPACITY && scan.Feed(ring[slot]); slot++) {}
+
+        for (int i = 0, slot = scan.OldestSlot(); i < scan.count; i++, slot = (slot + 1) % LOG_CAPACITY) {
+            if (RecordIsValid(ring[slot], generation)) writer.Append(*device, ring[slot]);
+        }
+        (*device)++;
+    }
+
+    if (offset != file.size) fprintf(stderr, "%s: ignoring %zu trailing bytes (not a whole image)\n", path, file.size - offset);
+    return true;
+}
+
+// -----------------------------
+// Reader
+// -----------------------------
+
+static bool GetU32(FILE* in, uint32_t* v) {
+    uint8_t b[4];
+    if (fread(b, 1, sizeof(b), in) != sizeof(b)) return false;
+    *v = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+    return true;
+}
+
+static int Decode(const char* path) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return 1;
+    }
+
+    char magic[sizeof(MAGIC)];
+    if (fread(magic, 1, sizeof(magic), in) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        fprintf(stderr, "%s: not a columnar log file\n", path);
+        fclose(in);
+        return 1;
+    }
+
+    // A size field can only be trusted as far as the bytes left in the file
+    struct stat st;
+    long fileSize = fstat(fileno(in), &st) == 0 ? (long)st.st_size : 0;
+
+    std::vector<uint8_t> chunk;
+    std::vector<int64_t> columns[COLUMNS];
+    uint32_t rows;
+
+    printf("device,epoch,subsecond,channel\n");
+    for (;;) {
+        // Every file ends with a zero row count; running out before it is truncation
+        if (!GetU32(in, &rows)) {
+            fprintf(stderr, "%s: truncated row group\n", path);
+            fclose(in);
+            return 1;
+        }
+        if (rows == 0) break;
+
+        for (int c = 0; c < COLUMNS; c++) {
+            uint32_t size = 0;
+            bool complete = GetU32(in, &size) && size <= fileSize - ftell(in);
+            if (complete) {
+                chunk.resize(size);
+                complete = fread(chunk.data(), 1, size, in) == size;
+            }
+            if (!complete) {
+                fprintf(stderr, "%s: truncated column %d\n", path, c);
+                fclose(in);
+                return 1;
+            }
+
+            ColumnReader reader(chunk.data(), size);
+            if (!reader.Decode(rows, columns[c])) {
+                fprintf(stderr, "%s: corrupt column %d\n", path, c);
+                fclose(in);
+                return 1;
+            }
+        }
+
+        for (uint32_t i = 0; i < rows; i++) {
+            printf("%lld,%lld,%lld,%lld\n", (long long)columns[3][i], (long long)columns[0][i],
+                   (long long)columns[1][i], (long long)columns[2][i]);
+        }
+    }
+
+    fclose(in);
+    return 0;
+}
+
+// -----------------------------
+// Main
+// -----------------------------
+
+static void Usage() {
+    fprintf(stderr, "usage: log2col -o out.col image.bin [image.bin ...]\n"
+                    "       log2col -d in.col\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "-d") == 0) return Decode(argv[2]);
+    if (argc < 4 || strcmp(argv[1], "-o") != 0) {
+        Usage();
+        return 2;
+    }
+
+    FILE* out = fopen(argv[2], "wb");
+    if (!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    static char outBuffer[1 << 20];
+    setvbuf(out, outBuffer, _IOFBF, sizeof(outBuffer));
+
+    auto start = std::chrono::steady_clock::now();
+    ColumnWriter writer(out);
+    uint32_t device = 0;
+    for (int i = 3; i < argc; i++) {
+        if (!EncodeFile(argv[i], writer, &device)) return 1;
+    }
+    uint64_t rows = writer.Finish();
+    long size = ftell(out);
+    fclose(out);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu events from %u devices, %ld bytes, %.1f M events/s\n", (unsigned long long)rows,
+            device, size, seconds > 0 ? rows / seconds / 1e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Host tool: runs the firmware's CSV export (LogStream.h, USB command 'd')
+// against an EEPROM image and writes it to a file, then reads the file back
+// and checks it row for row against the records decoded straight from the
+// image. The stream is also drained with odd packet sizes to make sure a
+// packet boundary never changes the bytes produced.
+//
+// Build:   g++ -O2 -std=c++17 -I.. logexport.cpp -o logexport
+// Run:     logexport image.bin out.csv
+//
+// Exit status is 1 if the file does not round-trip.
+
+#include "../LogStream.h"
+#include "ImageMap.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int PACKET_BYTES = 64; // Full-speed bulk packet, as on the board
+
+struct ImageSource {
+    const uint8_t* image;
+
+    void Read(unsigned eeaddress, char* data, int size) {
+        memcpy(data, image + eeaddress, size);
+    }
+};
+
+// Whole stream drained with one packet size
+static std::string Drain(ImageSource& source, const LogScan& scan, uint32_t generation, int packet) {
+    LogStream<ImageSource> stream(source, scan.head, scan.count, generation);
+    std::vector<char> buffer(packet);
+    std::string out;
+    int n;
+    while ((n = stream.Read(buffer.data(), packet)) > 0) out.append(buffer.data(), n);
+    return out;
+}
+
+static void Usage() {
+    fprintf(stderr, "usage: logexport image.bin out.csv\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        Usage();
+        return 2;
+    }
+
+    ImageMap map;
+    if (!map.Open(argv[1], IMAGE_READ, EEPROM_SIZE)) return 1;
+    const LogRecord* image = (const LogRecord*)map.data;
+    const LogRecord* ring = &image[LOG_BASE / LOG_RECORD_SIZE];
+    uint32_t generation = LogGeneration((const LogHeader*)&image[LOG_HEADER / LOG_RECORD_SIZE]);
+
+    LogScan scan(generation);
+    for (int slot = 0; slot < LOG_CAPACITY && scan.Feed(ring[slot]); slot++) {}
+
+    // Export to the file sink in bulk-packet sized writes
+    FILE* out = fopen(argv[2], "wb");
+    if (!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    ImageSource source = {map.data};
+    LogStream<ImageSource> stream(source, scan.head, scan.count, generation);
+    char packet[PACKET_BYTES];
+    int n;
+    while ((n = stream.Read(packet, sizeof(packet))) > 0) fwrite(packet, 1, n, out);
+    if (fclose(out) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    // Read the file back and compare with the ring, oldest record first
+    FILE* in = fopen(argv[2], "rb");
+    if (!in) {
+        perror(argv[2]);
+        return 1;
+    }
+    std::string text;
+    char chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), in)) > 0) text.append(chunk, got);
+    fclose(in);
+
+    int errors = 0;
+    size_t pos = text.find('\n');
+    if (pos == std::string::npos || text.compare(0, pos, "index,epoch,subsecond,channel,time") != 0) {
+        fprintf(stderr, "%s: missing CSV header\n", argv[2]);
+        return 1;
+    }
+    pos++;
+
+    int rows = 0;
+    for (int i = 0, slot = scan.OldestSlot(); i < scan.count; i++, slot = (slot + 1) % LOG_CAPACITY) {
+        const LogRecord& record = ring[slot];
+        if (!RecordIsValid(record, generation)) continue;
+
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) {
+            fprintf(stderr, "row %d: missing\n", rows);
+            errors++;
+            break;
+        }
+        int index;
+        unsigned long epoch;
+        unsigned subsecond, channel, hours, minutes, seconds;
+        std::string row = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        uint32_t second = record.epoch % 86400;
+        if (sscanf(row.c_str(), "%d,%lu,%u,%u,%u:%u:%u", &index, &epoch, &subsecond, &channel, &hours, &minutes,
+                   &seconds) != 7 ||
+            index != rows || epoch != record.epoch || subsecond != record.subsecond ||
+            channel != (unsigned)(record.tag & TAG_CHANNEL_MASK) || hours * 3600 + minutes * 60 + seconds != second) {
+            if (errors++ < 10) fprintf(stderr, "row %d: \"%s\" does not match slot %d\n", rows, row.c_str(), slot);
+        }
+        rows++;
+    }
+    if (pos != text.size()) {
+        fprintf(stderr, "%s: %zu unexpected trailing bytes\n", argv[2], text.size() - pos);
+        errors++;
+    }
+
+    // Packet boundaries must not change the output
+    for (int size : {1, 7, 61, 4096}) {
+        if (Drain(source, scan, generation, size) != text) {
+            fprintf(stderr, "packet size %d: output differs\n", size);
+            errors++;
+        }
+    }
+
+    printf("%d records (generation %lu) exported to %s, %zu bytes: %s\n", rows, (unsigned long)generation, argv[2],
+           text.size(), errors ? "MISMATCH" : "round trip ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+// Host tool: stress test for SeqLock.h, the lock the firmware shares its
+// clock state through. Writer threads (serialized by a mutex, standing in for
+// the ISR priority / critical section that keeps writers from preempting each
+// other on target) fill every word of a wide value with the same counter;
+// reader threads take snapshots with no lock and check that all words agree
+// and never go backwards. A torn snapshot fails the run.
+//
+// Build:   g++ -O2 -std=c++17 -pthread -I.. seqstress.cpp -o seqstress
+// Run:     seqstress [-w writers] [-r readers] [-t ms] [-u]
+//
+// -u copies the value without the sequence check, to show the test does
+// catch torn reads (expect a failure).
+
+#include "../SeqLock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int VALUE_WORDS = 16; // Wide enough that a copy spans cache lines
+
+struct Sample {
+    uint64_t word[VALUE_WORDS];
+};
+
+struct ReaderResult {
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+};
+
+static void Usage() {
+    fprintf(stderr, "usage: seqstress [-w writers] [-r readers] [-t ms] [-u]\n");
+}
+
+int main(int argc, char** argv) {
+    int writers = 2, readers = 4, ms = 1000;
+    bool unchecked = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) writers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) readers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-u") == 0) unchecked = true;
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (writers < 1 || readers < 1 || ms < 1) {
+        Usage();
+        return 2;
+    }
+
+    static SeqLock<Sample> shared(Sample{});
+    static Sample raw;            // Unlocked copy of the value for -u
+    std::mutex writeLock;
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> writes(0);
+    uint64_t counter = 0;         // Guarded by writeLock
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::lock_guard<std::mutex> lock(writeLock);
+                uint64_t next = ++counter;
+                shared.Write([next](Sample& s) {
+                    for (int i = 0; i < VALUE_WORDS; i++) s.word[i] = next;
+                });
+                if (unchecked) {
+                    for (int i = 0; i < VALUE_WORDS; i++) ((volatile uint64_t*)raw.word)[i] = next;
+                }
+                writes.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    std::vector<ReaderResult> results(readers);
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            ReaderResult& result = results[r];
+            uint64_t last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                Sample s;
+                if (unchecked) {
+                    for (int i = 0; i < VALUE_WORDS; i++) s.word[i] = ((volatile uint64_t*)raw.word)[i];
+                } else {
+                    s = shared.Read();
+                }
+                result.reads++;
+
+                bool torn = false;
+                for (int i = 1; i < VALUE_WORDS; i++) torn |= s.word[i] != s.word[0];
+                if (torn) result.torn++;
+                else if (s.word[0] < last) result.backwards++;
+                else last = s.word[0];
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    stop = true;
+    for (std::thread& t : threads) t.join();
+
+    ReaderResult total;
+    for (const ReaderResult& r : results) {
+        total.reads += r.reads;
+        total.torn += r.torn;
+        total.backwards += r.backwards;
+    }
+    printf("%d writers, %d readers, %d ms%s\n", writers, readers, ms, unchecked ? " (unchecked reads)" : "");
+    printf("writes     %llu\n", (unsigned long long)writes.load());
+    printf("reads      %llu\n", (unsigned long long)total.reads);
+    printf("retries    %lu (%.3f per read)\n", (unsigned long)shared.Retries(),
+           total.reads ? (double)shared.Retries() / total.reads : 0.0);
+    printf("torn       %llu\n", (unsigned long long)total.torn);
+    printf("backwards  %llu\n", (unsigned long long)total.backwards);
+
+    if (total.torn || total.backwards) {
+        fprintf(stderr, "FAIL: inconsistent snapshots\n");
+        return 1;
+    }
+    return 0;
+}